@@ -38,31 +38,29 @@ ArrayList::ArrayList(const ArrayList& other){
 
 /*
 Resizes the underlying cstring array in the list to allow for more elements.
-Increases the size of the ArrayList by RESIZE_FACTOR
+Doubles the size of the ArrayList, growing it by at least RESIZE_FACTOR. Only the array of pointers is copied,
+so the cstrings already in the list stay where they are and adding n elements costs O(n) overall
 */
 void ArrayList::resize(){
 
-    //Make new, larger array in the heap and initialize the cstrings
-    char** temp = new char*[numElements+RESIZE_FACTOR];
-    for(int i = 0; i < numElements+RESIZE_FACTOR; i++)
+    //Make new, larger array of pointers in the heap and initialize the cstrings past the existing ones
+    int growth = (numElements > RESIZE_FACTOR)? numElements: RESIZE_FACTOR;
+    char** temp = new char*[numElements+growth];
+    for(int i = numElements; i < numElements+growth; i++)
         temp[i] = new char[41];
 
-	//Copy the elements in the former array to the new one
-	for(int i = 0; i < numElements; i++){
-        for(int j = 0; j < 41; j++)
-            temp[i][j] = arrPointer[i][j];
-	}
+	//Move the existing cstrings over to the new array
+	for(int i = 0; i < numElements; i++)
+        temp[i] = arrPointer[i];
 
-	//Delete the original array from the heap
-    for(int i = 0; i < numElements; i++)
-        delete[] arrPointer[i];
+	//Delete the original array of pointers from the heap
 	delete [] arrPointer;
 
 	//Set arrPointer to point to new array in heap
 	arrPointer = temp;
 
-	//Reset the resize counter
-	resizeCounter = RESIZE_FACTOR;
+	//Reset the resize counter to the number of new cstrings
+	resizeCounter = growth;
 }
 
 /*
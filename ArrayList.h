@@ -1,7 +1,7 @@
 #ifndef _ARRAYLIST_H_
 #define _ARRAYLIST_H_
 
-//The number of indeces by which the array will expand on resize
+//The number of indeces the array starts with, and the fewest by which it will expand on resize
 #define RESIZE_FACTOR 10
 
 /*
@@ -10,7 +10,7 @@
 class ArrayList{
 	private:
         char** arrPointer; //The Array of cstring objects in the arraylist
-        int resizeCounter; //Counts down from RESIZE_Factor to zero (resize required at zero). While not required, it makes code a bit more readable
+        int resizeCounter; //Counts down the unused cstrings left in the array to zero (resize required at zero)
         int numElements; //Total number of initialized non-empty elements in the array
         void resize(); //Resize method called when numElements > size of array
 
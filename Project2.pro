@@ -1,15 +1,35 @@
 TEMPLATE = app
-CONFIG += console c++11
+CONFIG += console c++11 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
 SOURCES += \
     ArrayList.cpp \
     main.cpp \
-    arraylist2d.cpp
+    arraylist2d.cpp \
+    slabpool.cpp \
+    autoindex.cpp \
+    indexdaemon.cpp \
+    indexiterator.cpp \
+    dictionary.cpp \
+    tokenizer.cpp \
+    indexsnapshot.cpp \
+    snapshotstore.cpp \
+    termview.cpp \
+    snapshotreader.cpp
 
 HEADERS += \
     ArrayList.h \
     ianstring.h \
-    arraylist2d.h
+    arraylist2d.h \
+    slabpool.h \
+    autoindex.h \
+    indexdaemon.h \
+    indexiterator.h \
+    dictionary.h \
+    tokenizer.h \
+    indexsnapshot.h \
+    snapshotstore.h \
+    termview.h \
+    snapshotreader.h
 
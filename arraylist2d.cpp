@@ -12,10 +12,11 @@ ArrayList2D::ArrayList2D()
     //Allocate memory for pointers
     arrPointer = new int*[RESIZE_FACTOR];
     numElementsArr = new int[RESIZE_FACTOR];
+    sizeClassArr = new int[RESIZE_FACTOR];
 
-    //Allocate the main sublists and empty the numElementsArr to overwrite existing garbage
+    //Sublists are only taken from the pool once they receive their first item, so the spare slots stay empty
     for(int i =0; i < RESIZE_FACTOR; i++){
-        arrPointer[i] = new int[RESIZE_FACTOR];
+        arrPointer[i] = nullptr;
         numElementsArr[i] = 0;
     }
 
@@ -26,64 +27,59 @@ ArrayList2D::ArrayList2D()
 
 /*
 Resizes the main array to allow for more sublists.
-Turns an array of int[N][M] -> int[N+RESIZE_FACTOR][M].
-Keep in mind that this is not a rectangular 2D array so M != constant
+Turns an array of int[N][M] -> int[2N][M].
+Keep in mind that this is not a rectangular 2D array so M != constant.
+Only the pointers to the sublists are copied, the sublists themselves stay where they are in the pool
 */
 void ArrayList2D::resize(){
 
-    //Update true length to account for increased size and allocate memory for new array
-    true_length += RESIZE_FACTOR;
-    int** temp = new int*[true_length];
-    int* numElementsArrTemp = new int[true_length];
+    //Double the true length and allocate memory for the new arrays
+    int newTrueLength = true_length * 2;
+    int** temp = new int*[newTrueLength];
+    int* numElementsArrTemp = new int[newTrueLength];
+    int* sizeClassArrTemp = new int[newTrueLength];
 
-    //Allocate space for each subarray and copy existing elements into new arrays
+    //Copy over the existing sublist pointers along with their sizes
     for(int i = 0; i < length; i++){
-        //Alloc sublist for index i of new array
-        temp[i] = new int[(numElementsArr[i]%RESIZE_FACTOR) + RESIZE_FACTOR];
-
-        //Copy over existing elements to new subarrays
-        for(int j = 0; j < numElementsArr[i]; j++)
-            temp[i][j] = arrPointer[i][j];
-
-        //Save number of elements in each old subarray
+        temp[i] = arrPointer[i];
         numElementsArrTemp[i] = numElementsArr[i];
+        sizeClassArrTemp[i] = sizeClassArr[i];
     }
 
-    //Allocate the new subarrays, and set their size to zero.
-    //WARNING: These new subarrays contain garbage
-    for(int i = length; i < true_length; i++){
-        temp[i] = new int[RESIZE_FACTOR];
+    //Mark the new slots as empty
+    for(int i = length; i < newTrueLength; i++){
+        temp[i] = nullptr;
         numElementsArrTemp[i] = 0;
     }
 
-    //Delete all existing subarrays
-    for(int i = 0; i < length; i++){
-        delete[] arrPointer[i];
-    }
     //Delete main arrays
     delete[] arrPointer;
     delete[] numElementsArr;
+    delete[] sizeClassArr;
 
     //Assign pointers to newly allocated and copied arrays
     arrPointer = temp;
     numElementsArr = numElementsArrTemp;
+    sizeClassArr = sizeClassArrTemp;
+    true_length = newTrueLength;
 }
 
 /*
-Resizes the subarray at the specified index such that, in the main array,
-int[column] goes from length N to N + RESIZE_FACTOR
+Moves the sublist at the specified index into a block of the next pool size class,
+doubling its capacity. The old block goes back to the pool for reuse by other sublists
 @param column - the index of the subarray to resize
 */
 void ArrayList2D::resize(int column){
 
-    //Allocate space for the new array and copy over existing elements
-    int* temp = new int[numElementsArr[column]+RESIZE_FACTOR];
+    //Take a block of the next size class from the pool and copy over existing elements
+    int* temp = pool.allocate(sizeClassArr[column] + 1);
     for(int i =0; i < numElementsArr[column]; i++)
         temp[i] = arrPointer[column][i];
 
-    //Delete the existing array and adjust the pointer to the newly allocated array
-    delete[] arrPointer[column];
+    //Release the existing block and adjust the pointer to the new one
+    pool.release(arrPointer[column], sizeClassArr[column]);
     arrPointer[column] = temp;
+    sizeClassArr[column]++;
 }
 
 
@@ -91,12 +87,13 @@ void ArrayList2D::resize(int column){
 Checks if a sublist already contains an element.
 @param sublistIndex - the index of the sublist (column #) to be searched
 @param element - the element to search for in the sublist
-@return - true if 'element' appears in the sublist at arrPointer[sublistIndex]
+@param from - the index in the sublist at which the search starts
+@return - true if 'element' appears in the sublist at arrPointer[sublistIndex], at or after index 'from'
 */
-bool ArrayList2D::sublistContainsElement(int sublistIndex, int element){
+bool ArrayList2D::sublistContainsElement(int sublistIndex, int element, int from){
 
     //Parse through the sublist, checking for equality with each element
-    for(int i = 0; i < numElementsArr[sublistIndex]; i++)
+    for(int i = from; i < numElementsArr[sublistIndex]; i++)
         if(arrPointer[sublistIndex][i] == element)
             return true;
 
@@ -105,25 +102,27 @@ bool ArrayList2D::sublistContainsElement(int sublistIndex, int element){
 }
 
 /*
-Adds a new item to the specified sublist, resizing if necessary
+Adds a new item to the specified sublist, resizing if necessary. Only the tail of the sublist starting at
+index 'from' is kept sorted and free of duplicates, so a sublist can hold several sorted runs one after another
 @param newItem - the item to add to the sublist
 @param sublistIndex - the index in the main array of the sublist to which the new element should be added
+@param from - the index in the sublist at which the run the item belongs to starts
 */
-void ArrayList2D::addItemToSublist(int newItem, int sublistIndex){
+void ArrayList2D::addItemToSublist(int newItem, int sublistIndex, int from){
 
-    //If the sublist already contains this element, return. No action necessary
-    if(sublistContainsElement(sublistIndex, newItem)) return;
+    //If the run already contains this element, return. No action necessary
+    if(sublistContainsElement(sublistIndex, newItem, from)) return;
 
-    //Resize if needed
-    if(numElementsArr[sublistIndex]%RESIZE_FACTOR == 0) resize(sublistIndex);
+    //Resize if the sublist's block is full
+    if(numElementsArr[sublistIndex] == SlabPool::capacityOf(sizeClassArr[sublistIndex])) resize(sublistIndex);
 
     /*
     The following code is used for --SORTING ON INSERTION--
     Move the tracking variable 'index' forward until an element
     in the array is found whose value is greater than newItem
     */
-    int index = 0;
-    while(newItem > arrPointer[sublistIndex][index] && index < numElementsArr[sublistIndex]) index++;
+    int index = from;
+    while(index < numElementsArr[sublistIndex] && newItem > arrPointer[sublistIndex][index]) index++;
 
     //Push forward every item infront of the index where the new item will reside
     for(int i = numElementsArr[sublistIndex]; i > index; i--)
@@ -136,6 +135,20 @@ void ArrayList2D::addItemToSublist(int newItem, int sublistIndex){
     numElementsArr[sublistIndex]++;
 }
 
+/*
+Adds a new item to the end of the specified sublist, without sorting or checking for duplicates
+@param newItem - the item to add to the sublist
+@param sublistIndex - the index in the main array of the sublist to which the new element should be added
+*/
+void ArrayList2D::appendItemToSublist(int newItem, int sublistIndex){
+
+    //Resize if the sublist's block is full
+    if(numElementsArr[sublistIndex] == SlabPool::capacityOf(sizeClassArr[sublistIndex])) resize(sublistIndex);
+
+    arrPointer[sublistIndex][numElementsArr[sublistIndex]] = newItem;
+    numElementsArr[sublistIndex]++;
+}
+
 /*
 Creates a new sublist with one item -- newItem -- resizing if needed
 @param newItem - the item to be placed at index 0 of the new sublist
@@ -143,7 +156,11 @@ Creates a new sublist with one item -- newItem -- resizing if needed
 void ArrayList2D::addSublistWithNewItem(int newItem){
 
     //Resize if needed
-    if(length%RESIZE_FACTOR == 0 && length!=0) resize();
+    if(length == true_length) resize();
+
+    //Take the smallest block from the pool for the new sublist
+    arrPointer[length] = pool.allocate(0);
+    sizeClassArr[length] = 0;
 
     //Place the new item in the array, register it's size, and register the addition of the new sublist
     arrPointer[length][0] = newItem;
@@ -193,18 +210,23 @@ int ArrayList2D::get(int x, int y){
 }
 
 /*
-Destructor for ArrayList2D, deletes all sublists and all their elements
+Getter method for a whole sublist, so that callers can read it without copying it
+@param index - the sublist to be viewed
+@return - a pointer to the getSizeOfSublist(index) initialized items of the sublist. Adding to the sublist invalidates it
+*/
+const int* ArrayList2D::getSublist(int index){
+    return arrPointer[index];
+}
+
+/*
+Destructor for ArrayList2D. The sublists are freed by the pool's destructor, so only the main arrays are deleted here
 */
 ArrayList2D::~ArrayList2D(){
 
-    //Delete the array of sublist sizes
+    //Delete the arrays of sublist sizes and size classes
     delete[] numElementsArr;
-
-    //Delete every subarray
-    for(int i = 0; i < true_length; i++)
-        delete[] arrPointer[i];
+    delete[] sizeClassArr;
 
     //Delete the main array
     delete[] arrPointer;
 }
-
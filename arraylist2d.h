@@ -1,16 +1,21 @@
 #ifndef ARRAYLIST2D_H
 #define ARRAYLIST2D_H
 
+#include "slabpool.h"
+
 #define RESIZE_FACTOR 10
 
 /*
- * The ArrayList2D class contains a mutable 2d array of integers
+ * The ArrayList2D class contains a mutable 2d array of integers.
+ * Sublists are carved out of a SlabPool owned by the list, so they are all freed together with it
  */
 class ArrayList2D
 {
 private:
     int** arrPointer; //Main data array. 2D int array
     int* numElementsArr;//Array of the lengths of the sublists. numElementsArr[n] represents the number of used slots in arrPointer[n]
+    int* sizeClassArr; //Array of the pool size classes of the sublists. arrPointer[n] has room for SlabPool::capacityOf(sizeClassArr[n]) ints
+    SlabPool pool; //Pool from which every sublist is allocated
     int length; //Number of initialized, non empty sublists
     int true_length; //Number of pointers in arrPointer array
     void resize(); //Resize the main list, allowing for additional sublists to be added
@@ -18,14 +23,18 @@ private:
 
 public:
     ArrayList2D(); //Default constructor
-    void addItemToSublist(int, int); //Adds a new item to a specified sublist
+    ArrayList2D(const ArrayList2D&) = delete; //Sublists belong to this list's pool, so lists cannot be copied
+    ArrayList2D& operator=(const ArrayList2D&) = delete;
+    void addItemToSublist(int, int, int = 0); //Adds a new item to a specified sublist, keeping the sublist (or its tail) sorted
+    void appendItemToSublist(int, int); //Adds a new item to the end of a specified sublist
     void addSublistWithNewItem(int); //Creates a new sublist and adds a new item to that list
-    bool sublistContainsElement(int, int); //Checks if a sublist contains an element
+    bool sublistContainsElement(int, int, int = 0); //Checks if a sublist (or its tail) contains an element
     ~ArrayList2D(); //Destructor
     int getNumberOfSublists(); //Getter for the width of the 2D array
     int getSizeOfSublist(int); //Getter for the height of one column of the array
     void print(); //Prints the contents of the array for debugging
     int get(int, int); //Gets one specific int from coordinates in the 2D array
+    const int* getSublist(int); //Gets a read only view of one sublist
 };
 
 #endif
@@ -0,0 +1,638 @@
+#include "autoindex.h"
+#include "indexiterator.h"
+
+#include <cstring>
+#include <cctype>
+#include <thread>
+#include <algorithm>
+
+using namespace std;
+
+int strCompare(char*, char*); //Compare the alphabetical order of two cstrings
+int numDigits(int); //Calculates the number of digits in an integer
+void writePages(const int*, int, int, int, ostream&); //Writes a list of page numbers, wrapping lines at 50 characters
+
+//Values of a reader slot that isn't reading a snapshot. Any other value is the epoch the reader started reading in
+#define READER_FREE 0
+#define READER_IDLE 1
+#define READER_FIRST_EPOCH 2
+
+/*
+Helper method -- calculates the number of digits in a given integer
+Used to limit file output lines to 50 characters each
+@param number - the number whose digits are to be counter
+@return - the number of digits in 'number'
+*/
+int numDigits(int number){
+
+    //Divide number by 10 using integer division until 0 is reached, saving the number of iterations
+    int numDigits = 0;
+    do {
+        numDigits++;
+        number /= 10;
+    } while(number != 0);
+
+    //Return the number of iterations over which the number was divided by 10, and therefore the number of digits in 'number'
+    return numDigits;
+}
+
+/*
+Helper method - writes a comma separated list of page numbers, moving onto a new indented line whenever a number
+would take the line past 50 characters. The last number is followed by a space instead of a comma
+@param pages - the page numbers to write
+@param count - the number of page numbers
+@param lineLength - the length of the line before the first number
+@param indent - the number of spaces at the start of every new line
+@param outputFileStream - the stream to which the numbers will be written
+*/
+void writePages(const int* pages, int count, int lineLength, int indent, ostream& outputFileStream){
+
+    //For every page, print the page number followed by a comma (excluding comma for last page)
+    for(int k = 0; k < count; k++){
+
+        //If writing this number would exceed the 50 character limit for the line
+        if(numDigits(pages[k]) >= 50 - lineLength - 1){
+
+            //Move onto a new line
+            outputFileStream << '\n';
+            for(int i = 0; i < indent; i++)
+                outputFileStream << ' ';
+            lineLength = indent;
+        }
+
+        //Output the number to the file, ternary operator used to add a comma only if the number is not the last, and save the increase in line size
+        outputFileStream << pages[k] << ((k == count-1)? " ": ", ");
+        lineLength += numDigits(pages[k]) + 2;
+    }
+}
+
+/*
+Helper method - compares two cstrings to one another based on alphabetical order
+@param str1, str2 - the cstrings to compare
+@return - negative if str1 appears first alphabetically, 0 if equal, positive if str1 appears second alphabetically
+*/
+int strCompare(char* str1, char* str2){
+
+    //Move through the cstrings until non matching characters are found, or the end of the strings is found
+    int index = 0;
+    while(str1[index] != '\0' && str2[index] != '\0' &&str1[index] == str2[index]) index++;
+
+    //Return the difference in the first non-matching chars, or zero if they're both null terminators
+    return str1[index] - str2[index];
+}
+
+/*
+Default constructor for an AutoIndex. Words are registered on page 0 until a page marker is seen
+*/
+AutoIndex::AutoIndex() : dictionary(words)
+{
+    currentPageNumber = 0;
+    currentDocument = 0;
+    batchSize = 0;
+    documents = nullptr;
+    numDocuments = 0;
+    documentCapacity = 0;
+
+    //Snapshots are off until enableSnapshots is called, and every reader slot starts out free
+    snapshotsEnabled = false;
+    wordsSinceSnapshot = 0;
+    published = nullptr;
+    epoch = READER_FIRST_EPOCH;
+    for(int i = 0; i < MAX_SNAPSHOT_READERS; i++)
+        readerEpochs[i] = READER_FREE;
+    retired = nullptr;
+}
+
+/*
+Writes the formatted index to a stream, one [N] section per first letter. Terms are written as soon as
+their section has been sorted, so the start of the output doesn't wait on the rest of the index
+@param outputFileStream - the stream to which the output will be written
+@param maxTerms - the number of terms after which to stop, or -1 to write every term
+@return - the number of terms written
+*/
+int AutoIndex::write(ostream& outputFileStream, int maxTerms){
+
+    //Walk the terms in alphabetical order, starting a new [N] heading at the first term of every section
+    IndexIterator terms(*this);
+    int written = 0;
+    while(written != maxTerms && terms.next()){
+        if(terms.startsSection())
+            outputFileStream << '[' << (char)(toupper((unsigned char)terms.getSectionChar())) << ']' << endl;
+        writeEntry(terms, outputFileStream);
+        written++;
+    }
+
+    return written;
+}
+
+/*
+Writes the formatted section of terms starting with one character, under its [N] heading. Only that section is sorted
+@param firstChar - the first character of the terms to write
+@param outputFileStream - the stream to which the section will be written
+@return - the number of terms written. Nothing, not even the heading, is written if no term starts with firstChar
+*/
+int AutoIndex::writeSection(char firstChar, ostream& outputFileStream){
+
+    //Terms are stored in lower case. The character goes through unsigned char first, since tolower is undefined for negative values
+    char sectionChar = (char)tolower((unsigned char)firstChar);
+
+    //Move to the section and write terms until the iterator leaves it
+    IndexIterator terms(*this);
+    terms.seekSection(sectionChar);
+    int written = 0;
+    while(terms.next() && terms.getSectionChar() == sectionChar){
+        if(written == 0)
+            outputFileStream << '[' << (char)(toupper((unsigned char)terms.getSectionChar())) << ']' << endl;
+        writeEntry(terms, outputFileStream);
+        written++;
+    }
+
+    return written;
+}
+
+/*
+Writes the term an iterator is on followed by a colon and its pages, wrapping the pages onto indented lines
+so that no line is longer than 50 characters. In a corpus, the term is followed by one indented line per document
+it appeared in, each naming the document and listing the pages in it
+@param terms - the iterator whose current term will be written
+@param outputFileStream - the stream to which the term will be written
+*/
+void AutoIndex::writeEntry(IndexIterator& terms, ostream& outputFileStream){
+
+    //Print the word followed by a colon, and then every page on which it appeared
+    if(!isCorpus()){
+        outputFileStream << terms.getTerm() << ": ";
+        writePages(terms.getPages(), terms.getPageCount(), 2 + strlen(terms.getTerm()), 4, outputFileStream);
+        outputFileStream << endl;
+        return;
+    }
+
+    //In a corpus, print the word on a line of its own, followed by a line for each document in which it appeared
+    outputFileStream << terms.getTerm() << ":" << endl;
+    TermView term = getView(terms.getTermId());
+    for(int b = 0; b < term.getBlockCount(); b++){
+        char* name = documents[term.getBlockDocument(b)];
+        int count;
+        const int* pages = term.getBlockPages(b, count);
+        outputFileStream << "    " << name << ": ";
+        writePages(pages, count, 6 + strlen(name), 8, outputFileStream);
+        outputFileStream << endl;
+    }
+}
+
+/*
+Writes a single term followed by a colon and a comma separated list of the pages it appeared on, all on one line,
+in the format described by TermView::write
+@param id - the id of the term to write
+@param out - the stream to which the term will be written
+*/
+void AutoIndex::writeTerm(int id, ostream& out){
+    getView(id).write(isCorpus()? documents: nullptr, out);
+}
+
+/*
+Writes a single term followed by a colon and a comma separated list of the pages it appeared on in one document
+@param id - the id of the term to write
+@param document - the id of the document
+@param out - the stream to which the term will be written
+*/
+void AutoIndex::writeTermInDocument(int id, int document, ostream& out){
+    getView(id).writeInDocument(document, out);
+}
+
+/*
+Writes every term that starts with a prefix, one per line in alphabetical order, in the format used by writeTerm
+@param prefix - the cstring every written term starts with. Case is ignored
+@param out - the stream to which the terms will be written
+@return - the number of terms written
+*/
+int AutoIndex::writePrefix(char* prefix, ostream& out){
+
+    //Make sure every word read so far is in the list being searched
+    flush();
+
+    //Find the matching words in alphabetical order and write them out
+    int* ids = new int[words.size()];
+    ArrayList* list = &words;
+    int numMatches = findPrefix(prefix, words.size(), [list](int id){ return list->get(id); }, ids);
+    for(int i = 0; i < numMatches; i++)
+        writeTerm(ids[i], out);
+
+    delete[] ids;
+    return numMatches;
+}
+
+/*
+Reads data from a stream, inputting words, [multi word phrases] and <n> page markers into the index.
+The stream is read in chunks of READ_CHUNK bytes, each of which is handed to feed
+@param file - the stream from which input will be read
+@return - true if the <-1> end marker was reached, false if the stream ran out first
+*/
+bool AutoIndex::read(istream& file){
+
+    //Feed the stream to the tokenizer one chunk at a time, stopping early at the end marker
+    char buffer[READ_CHUNK];
+    while(file.read(buffer, READ_CHUNK) || file.gcount() > 0){
+        if(feed(buffer, file.gcount())){
+            if(snapshotsEnabled) publishSnapshot();
+            return true;
+        }
+    }
+
+    //Register whatever token the stream ended in the middle of, along with the words left in the last batch
+    int type = tokenizer.finish();
+    if(type == TOKEN_WORD) addWord(tokenizer.getToken());
+    if(type == TOKEN_PAGE) setPage(tokenizer.getPage());
+    flush();
+
+    //Let snapshot readers see the end of the stream
+    if(snapshotsEnabled) publishSnapshot();
+    return false;
+}
+
+/*
+Inputs words, [multi word phrases] and <n> page markers from a buffer into the index. A token cut off at the
+end of the buffer is finished by the next call, so a phrase can be spread over several buffers
+@param text - the buffer to read
+@param length - the number of chars in the buffer
+@return - true if the <-1> end marker was reached, in which case the rest of the buffer is ignored
+*/
+bool AutoIndex::feed(const char* text, int length){
+
+    //Register each token as the tokenizer completes it
+    const char* cursor = text;
+    const char* end = text + length;
+    int type;
+    while((type = tokenizer.next(cursor, end)) != TOKEN_NONE){
+        if(type == TOKEN_WORD){
+            addWord(tokenizer.getToken());
+        } else if(type == TOKEN_PAGE){
+            setPage(tokenizer.getPage());
+        } else {
+            //Register the words left in the batch and stop at the end marker
+            flush();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+Registers a word (or phrase) as having been found on the current page. Words are stored in lower case and cut off at 40 characters.
+The word is held in a batch and only looked up once DICTIONARY_BATCH words are waiting, so that the dictionary can
+overlap their lookups; flush registers a partial batch
+@param word - the cstring to register
+*/
+void AutoIndex::addWord(char* word){
+
+    //Copy the word into the next full size, lower case cstring of the batch, since the ArrayList copies 41 chars at a time
+    char* inputToken = batchWords[batchSize];
+    int length = 0;
+    for(; length < 40 && word[length] != '\0'; length++)
+        inputToken[length] = tolower((unsigned char)word[length]);
+    memset(inputToken + length, 0, 41 - length);
+    batchPages[batchSize] = currentPageNumber;
+    batchSize++;
+
+    //Look the batch up once it is full
+    if(batchSize == DICTIONARY_BATCH) flush();
+}
+
+/*
+Looks up every word waiting in the batch and registers each of them on the page it was found on.
+Called before anything reads the words or pages of the index
+*/
+void AutoIndex::flush(){
+    if(batchSize == 0) return;
+
+    //Get the ids of the whole batch at once, adding the new words to the words ArrayList
+    char* batch[DICTIONARY_BATCH];
+    int ids[DICTIONARY_BATCH];
+    bool inserted[DICTIONARY_BATCH];
+    for(int i = 0; i < batchSize; i++)
+        batch[i] = batchWords[i];
+    dictionary.lookupOrInsert(batch, batchSize, ids, inserted);
+
+    //Update the page lists in the same order. New words were given the next ids in order, so each gets the next new sublist
+    for(int i = 0; i < batchSize; i++){
+        if(inserted[i]){
+
+            //Start the word's pages, along with a skip list whose only block starts at its first page
+            numbers.addSublistWithNewItem(batchPages[i]);
+            documentBlocks.addSublistWithNewItem(currentDocument);
+            documentBlocks.appendItemToSublist(0, ids[i]);
+        } else {
+
+            //Find where the word's block for the current document starts, opening a new block if its last one belongs to an earlier document
+            int skipLength = documentBlocks.getSizeOfSublist(ids[i]);
+            int blockStart = documentBlocks.get(ids[i], skipLength-1);
+            if(documentBlocks.get(ids[i], skipLength-2) != currentDocument){
+                blockStart = numbers.getSizeOfSublist(ids[i]);
+                documentBlocks.appendItemToSublist(currentDocument, ids[i]);
+                documentBlocks.appendItemToSublist(blockStart, ids[i]);
+            }
+
+            //Let the snapshot store know the word changed, and whether the page may have gone before pages it already shares
+            int size = numbers.getSizeOfSublist(ids[i]);
+            if(snapshotsEnabled) snapshotStore.touch(ids[i], size > blockStart && batchPages[i] < numbers.get(ids[i], size-1));
+
+            //Register the page in that block, which is kept sorted on its own
+            numbers.addItemToSublist(batchPages[i], ids[i], blockStart);
+        }
+    }
+
+    //Take a new snapshot every SNAPSHOT_MIN_WORDS words, or less often if the pointers every snapshot copies would cost
+    //more than a constant amount per word
+    if(snapshotsEnabled){
+        wordsSinceSnapshot += batchSize;
+        if(wordsSinceSnapshot >= max((long)SNAPSHOT_MIN_WORDS, (long)snapshotStore.publishCost())) takeSnapshot();
+    }
+
+    batchSize = 0;
+}
+
+/*
+Setter for the page on which following words are registered
+@param page - the new current page
+*/
+void AutoIndex::setPage(int page){
+    currentPageNumber = page;
+}
+
+/*
+Helper method - adds a copy of a name to the end of the list of documents, doubling the list if it is full
+@param name - the name of the document
+*/
+void AutoIndex::addDocument(const char* name){
+    if(numDocuments == documentCapacity){
+        documentCapacity = (documentCapacity == 0)? RESIZE_FACTOR: documentCapacity * 2;
+        char** temp = new char*[documentCapacity];
+        for(int i = 0; i < numDocuments; i++)
+            temp[i] = documents[i];
+        delete[] documents;
+        documents = temp;
+    }
+
+    documents[numDocuments] = new char[strlen(name) + 1];
+    strcpy(documents[numDocuments], name);
+    numDocuments++;
+}
+
+/*
+Starts a new document of the corpus. Following words are registered in it, starting on page 0.
+If words were read before the first document was started, they are kept as a document named "untitled"
+@param name - the name of the document, kept in full
+@return - false if a document with that name already exists, in which case following words stay in the current document
+*/
+bool AutoIndex::beginDocument(char* name){
+
+    //Register the words of the previous document before switching
+    flush();
+
+    //Give the words read before the first document a document of their own
+    if(numDocuments == 0 && words.size() > 0)
+        addDocument("untitled");
+
+    //Names are how documents are looked up, so no two documents may share one
+    if(indexOfDocument(name) != -1) return false;
+    addDocument(name);
+
+    currentDocument = numDocuments - 1;
+    currentPageNumber = 0;
+    return true;
+}
+
+/*
+Checks whether the index is a corpus, meaning beginDocument has been called
+@return - true if the index holds named documents
+*/
+bool AutoIndex::isCorpus() const{
+    return numDocuments > 0;
+}
+
+/*
+Getter for the number of documents in the corpus
+@return - the number of documents, or 0 if the index isn't a corpus
+*/
+int AutoIndex::getNumberOfDocuments() const{
+    return numDocuments;
+}
+
+/*
+Gets the name of a document
+@param document - the id of the document
+@return - the name given to beginDocument
+*/
+char* AutoIndex::getDocumentName(int document) const{
+    return documents[document];
+}
+
+/*
+Calculates the id of a document from its name
+@param name - the name of the document
+@return - the id of the document, or -1 if no document has that name
+*/
+int AutoIndex::indexOfDocument(char* name){
+    for(int i = 0; i < numDocuments; i++)
+        if(strcmp(documents[i], name) == 0) return i;
+    return -1;
+}
+
+/*
+Calculates the id of a word in the index. The lookup ignores case and anything past 40 characters
+@param word - the cstring to look up
+@return - the id of the word, or -1 if it doesn't appear in the index
+*/
+int AutoIndex::indexOf(char* word){
+
+    //Make sure every word read so far is in the dictionary
+    flush();
+
+    //Move the word to a lower case cstring so it can be compared against the saved words
+    char key[41] = {0};
+    for(int i = 0; i < 40 && word[i] != '\0'; i++)
+        key[i] = tolower((unsigned char)word[i]);
+
+    return dictionary.lookup(key);
+}
+
+/*
+Getter for the number of distinct words in the index
+@return - the number of words stored
+*/
+int AutoIndex::size() const{
+    return words.size();
+}
+
+/*
+Gets the word with the given id
+@param id - the id of the word
+@return - the lower case cstring for that word
+*/
+char* AutoIndex::getTerm(int id) const{
+    return words.get(id);
+}
+
+/*
+Gets the number of distinct pages on which a word appeared
+@param id - the id of the word
+@return - the number of pages saved for that word
+*/
+int AutoIndex::getPageCount(int id){
+    return numbers.getSizeOfSublist(id);
+}
+
+/*
+Gets one of the pages on which a word appeared. Pages are kept in increasing order within each document
+@param id - the id of the word
+@param index - the position of the page in the word's list
+@return - the page number
+*/
+int AutoIndex::getPage(int id, int index){
+    return numbers.get(id, index);
+}
+
+/*
+Gets a view of the pages on which a word appeared, without copying them
+@param id - the id of the word
+@return - a pointer to getPageCount(id) page numbers, in increasing order within each document. Adding words to the index invalidates it
+*/
+const int* AutoIndex::getPages(int id){
+    return numbers.getSublist(id);
+}
+
+/*
+Gets a view of a word and the pages it appeared on, split into one block per document, without copying them.
+An index that isn't a corpus has one block per word
+@param id - the id of the word
+@return - the view. Adding words to the index invalidates it
+*/
+TermView AutoIndex::getView(int id){
+    return TermView(words.get(id), numbers.getSublist(id), numbers.getSizeOfSublist(id),
+                    documentBlocks.getSublist(id), documentBlocks.getSizeOfSublist(id));
+}
+
+/*
+Starts publishing snapshots. Snapshots are taken as words are registered, at the end of every read, and whenever publishSnapshot is called
+*/
+void AutoIndex::enableSnapshots(){
+    snapshotsEnabled = true;
+}
+
+/*
+Registers the words waiting in the batch and publishes a snapshot of the whole index, unless nothing
+has been registered since the last snapshot. Only the thread adding to the index may call this
+*/
+void AutoIndex::publishSnapshot(){
+    flush();
+    if(wordsSinceSnapshot > 0 || published.load() == nullptr) takeSnapshot();
+}
+
+/*
+Builds a new snapshot from what changed since the last one and publishes it in place of the last one. The last one is retired
+in the current epoch, along with the blocks it used that the new one doesn't, and the epoch moves on so that readers
+starting from now on can't be using them
+*/
+void AutoIndex::takeSnapshot(){
+    IndexSnapshot* old = published.exchange(snapshotStore.build(words, numbers, documentBlocks, documents, numDocuments));
+    wordsSinceSnapshot = 0;
+
+    //Add the replaced snapshot to the retired list, then move on to the next epoch.
+    //Blocks replaced while building the first snapshot were never published, so they can go right away
+    if(old != nullptr){
+        old->retireEpoch = epoch.load();
+        old->nextRetired = retired;
+        retired = old;
+    }
+    snapshotStore.retirePending((old != nullptr)? old->retireEpoch: 0);
+    epoch++;
+
+    reclaimSnapshots();
+}
+
+/*
+Deletes every retired snapshot, and every block only retired snapshots used, that no reader can still be using. A reader announces
+the epoch it started in before it loads the latest snapshot, so a snapshot retired in an epoch earlier than every announced one can't be in use
+*/
+void AutoIndex::reclaimSnapshots(){
+
+    //Find the earliest epoch any reader is reading in
+    unsigned long oldest = epoch.load();
+    for(int i = 0; i < MAX_SNAPSHOT_READERS; i++){
+        unsigned long readerEpoch = readerEpochs[i].load();
+        if(readerEpoch >= READER_FIRST_EPOCH && readerEpoch < oldest) oldest = readerEpoch;
+    }
+
+    //Delete the snapshots retired before it, keeping the rest in the list
+    IndexSnapshot** link = &retired;
+    while(*link != nullptr){
+        IndexSnapshot* snapshot = *link;
+        if(snapshot->retireEpoch < oldest){
+            *link = snapshot->nextRetired;
+            delete snapshot;
+        } else {
+            link = &snapshot->nextRetired;
+        }
+    }
+    snapshotStore.reclaim(oldest);
+}
+
+/*
+Reserves a reader slot for the calling thread, waiting for one to free up if all MAX_SNAPSHOT_READERS are taken
+@return - the reader slot, to be passed to acquireSnapshot, releaseSnapshot and releaseReaderSlot
+*/
+int AutoIndex::claimReaderSlot(){
+    while(true){
+        for(int i = 0; i < MAX_SNAPSHOT_READERS; i++){
+            unsigned long expected = READER_FREE;
+            if(readerEpochs[i].compare_exchange_strong(expected, READER_IDLE)) return i;
+        }
+        this_thread::yield();
+    }
+}
+
+/*
+Gives back a reader slot. Any snapshot acquired through it must have been released
+@param slot - the slot returned by claimReaderSlot
+*/
+void AutoIndex::releaseReaderSlot(int slot){
+    readerEpochs[slot] = READER_FREE;
+}
+
+/*
+Gets the latest snapshot of the index. The snapshot won't be deleted until releaseSnapshot is called on the same slot,
+even if newer snapshots are published in the meantime. Takes no locks and never waits for the thread adding to the index
+@param slot - the reader slot of the calling thread
+@return - the latest snapshot, or nullptr if none has been published yet
+*/
+const IndexSnapshot* AutoIndex::acquireSnapshot(int slot){
+
+    //Announce the current epoch before loading the snapshot, so the writer knows not to delete it
+    readerEpochs[slot] = epoch.load();
+    return published.load();
+}
+
+/*
+Lets the snapshot acquired through a reader slot be deleted once it has been replaced
+@param slot - the reader slot of the calling thread
+*/
+void AutoIndex::releaseSnapshot(int slot){
+    readerEpochs[slot] = READER_IDLE;
+}
+
+/*
+Destructor for AutoIndex. Deletes the published snapshot, every retired one and the document names
+*/
+AutoIndex::~AutoIndex(){
+    delete published.load();
+    while(retired != nullptr){
+        IndexSnapshot* next = retired->nextRetired;
+        delete retired;
+        retired = next;
+    }
+
+    for(int i = 0; i < numDocuments; i++)
+        delete[] documents[i];
+    delete[] documents;
+}
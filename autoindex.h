@@ -0,0 +1,102 @@
+#ifndef AUTOINDEX_H
+#define AUTOINDEX_H
+
+#include <istream>
+#include <ostream>
+#include <atomic>
+
+#include "ArrayList.h"
+#include "arraylist2d.h"
+#include "dictionary.h"
+#include "tokenizer.h"
+#include "indexsnapshot.h"
+#include "snapshotstore.h"
+#include "termview.h"
+
+//The number of bytes read from a stream at a time
+#define READ_CHUNK 16384
+//The most threads that can read snapshots of one index at the same time
+#define MAX_SNAPSHOT_READERS 64
+//The fewest words registered between two snapshots. Snapshots are also spaced by SnapshotStore::publishCost words, so that
+//the pointers every snapshot copies cost a constant amount per word. A snapshot therefore lags the index by at most
+//max(SNAPSHOT_MIN_WORDS, terms / SNAPSHOT_CHUNK + documents) words, and at the end of every read it catches up completely
+#define SNAPSHOT_MIN_WORDS 4096
+
+class IndexIterator;
+
+/*
+ * The AutoIndex class holds one index: the words that were found and, in a parallel list,
+ * the sorted pages on which each of them appeared.
+ * An index can also cover a corpus of several documents, each started with beginDocument. A word's pages are then kept
+ * as one sorted block per document it appeared in, with a skip list of (document, start of block) pairs so that the
+ * pages of one document can be found without reading the blocks of the others.
+ * Only one thread may add to an index or read it directly. Once snapshots are enabled, the index also publishes
+ * immutable IndexSnapshots as it grows, which any number of other threads can read through a SnapshotReader
+ * without locking. Consecutive snapshots share everything that didn't change between them through a SnapshotStore,
+ * so publishing one costs about as much as what changed since the last one rather than the size of the whole index.
+ * Replaced snapshots are deleted once no reader that could still be using them is left
+ */
+class AutoIndex
+{
+private:
+    ArrayList words; //The list of words being stored
+    ArrayList2D numbers; //The list of lists of page numbers for each word being stored
+    ArrayList2D documentBlocks; //Skip list for each word: pairs of a document id and the index in numbers where its pages start
+    char** documents; //Names of the documents in a corpus, of any length and all different. Empty until beginDocument is first called
+    int numDocuments; //Number of names in documents
+    int documentCapacity; //Number of pointers in documents
+    int currentDocument; //The document that newly added words are registered in
+    Dictionary dictionary; //Hash table from each word to its index in 'words'
+    Tokenizer tokenizer; //Splits input into words, phrases and page markers, keeping unfinished tokens between calls to feed
+    int currentPageNumber; //The page that newly added words are registered on
+    char batchWords[DICTIONARY_BATCH][41]; //Words waiting to be looked up in the dictionary as one batch
+    int batchPages[DICTIONARY_BATCH]; //Page each waiting word was found on
+    int batchSize; //Number of words waiting in the batch
+    bool snapshotsEnabled; //Whether snapshots are published as words are registered
+    long wordsSinceSnapshot; //Number of words registered since the last snapshot was taken
+    std::atomic<IndexSnapshot*> published; //The latest snapshot, or nullptr if none has been taken
+    std::atomic<unsigned long> epoch; //Counts the snapshots replaced so far, starting at READER_FIRST_EPOCH
+    std::atomic<unsigned long> readerEpochs[MAX_SNAPSHOT_READERS]; //The epoch each reader started reading in, or READER_FREE / READER_IDLE
+    IndexSnapshot* retired; //Replaced snapshots that may still be in use by a reader
+    SnapshotStore snapshotStore; //Builds snapshots, keeping what they share with one another
+    void addDocument(const char*); //Adds a copy of a name to the list of documents
+    void takeSnapshot(); //Publishes a snapshot of the words registered so far
+    void reclaimSnapshots(); //Deletes the replaced snapshots that no reader can still be using
+
+public:
+    AutoIndex(); //Default constructor
+    AutoIndex(const AutoIndex&) = delete; //Indexes own their lists, which cannot be copied
+    AutoIndex& operator=(const AutoIndex&) = delete;
+    ~AutoIndex(); //Destructor, deletes the snapshots. No reader may be using them
+    bool read(std::istream&); //Reads words, phrases and page markers from a stream into the index
+    bool feed(const char*, int); //Reads words, phrases and page markers from a buffer into the index
+    int write(std::ostream&, int = -1); //Writes the formatted index, or only its first terms, to a stream
+    int writeSection(char, std::ostream&); //Writes the formatted section of terms starting with one character to a stream
+    void writeEntry(IndexIterator&, std::ostream&); //Writes the formatted lines for the term an iterator is on
+    void writeTerm(int, std::ostream&); //Writes one term followed by the pages it appeared on
+    int writePrefix(char*, std::ostream&); //Writes every term starting with a prefix, in alphabetical order
+    void addWord(char*); //Registers a word on the current page
+    void flush(); //Registers every word still waiting in the batch
+    void setPage(int); //Sets the page that following words are registered on
+    bool beginDocument(char*); //Starts a new document of the corpus, registering following words in it, unless the name is taken
+    bool isCorpus() const; //Whether the index was built from named documents
+    int getNumberOfDocuments() const; //Getter for the number of documents in the corpus
+    char* getDocumentName(int) const; //Gets the name of a document
+    int indexOfDocument(char*); //Gets the id of a document from its name, or -1 if there is no such document
+    int indexOf(char*); //Gets the id of a word, or -1 if it isn't in the index
+    int size() const; //Getter for the number of distinct words in the index
+    char* getTerm(int) const; //Gets the word with the given id
+    int getPageCount(int); //Gets the number of pages on which a word appeared
+    int getPage(int, int); //Gets one of the pages on which a word appeared
+    const int* getPages(int); //Gets a read only view of the pages on which a word appeared
+    TermView getView(int); //Gets a read only view of a word and its blocks of pages
+    void writeTermInDocument(int, int, std::ostream&); //Writes one term followed by the pages it appeared on in one document
+    void enableSnapshots(); //Starts publishing snapshots for other threads to read
+    void publishSnapshot(); //Publishes a snapshot of everything read so far, if anything changed since the last one
+    int claimReaderSlot(); //Reserves a reader slot for a thread that will read snapshots
+    void releaseReaderSlot(int); //Gives back a reader slot
+    const IndexSnapshot* acquireSnapshot(int); //Gets the latest snapshot, which stays valid until releaseSnapshot
+    void releaseSnapshot(int); //Lets the snapshot acquired through a reader slot be deleted once it has been replaced
+};
+
+#endif
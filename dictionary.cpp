@@ -0,0 +1,153 @@
+#include "dictionary.h"
+
+#include <cstring>
+
+/*
+Constructor for a Dictionary. Any words already in the list are hashed into the table
+@param wordList - the list whose indexes are used as the ids of the words
+*/
+Dictionary::Dictionary(ArrayList& wordList) : words(wordList)
+{
+    slots = nullptr;
+    slotHashes = nullptr;
+    capacity = 0;
+
+    //Start with a table big enough for the existing words at half load
+    int startCapacity = DICTIONARY_START_CAPACITY;
+    while(startCapacity < words.size() * 2) startCapacity *= 2;
+    resize(startCapacity);
+}
+
+/*
+Helper method - hashes a cstring with 32 bit FNV-1a
+@param str - the cstring to hash
+@return - the hash of every character before the null terminator
+*/
+unsigned int Dictionary::hash(const char* str){
+    unsigned int result = 2166136261u;
+    for(int i = 0; str[i] != '\0'; i++){
+        result ^= (unsigned char)str[i];
+        result *= 16777619u;
+    }
+    return result;
+}
+
+/*
+Moves every word into a new table with a different number of slots
+@param newCapacity - the number of slots in the new table, a power of two
+*/
+void Dictionary::resize(int newCapacity){
+
+    //Allocate the new table and mark every slot as empty
+    int* newSlots = new int[newCapacity];
+    unsigned int* newSlotHashes = new unsigned int[newCapacity];
+    for(int i = 0; i < newCapacity; i++)
+        newSlots[i] = -1;
+
+    //Reinsert the words already in the old table using their saved hashes, so that no word has to be read again
+    int mask = newCapacity - 1;
+    for(int old = 0; old < capacity; old++){
+        if(slots[old] == -1) continue;
+        int slot = slotHashes[old] & mask;
+        while(newSlots[slot] != -1) slot = (slot + 1) & mask;
+        newSlots[slot] = slots[old];
+        newSlotHashes[slot] = slotHashes[old];
+    }
+
+    //Hash the words of the list if there is no old table yet
+    if(slots == nullptr){
+        for(int id = 0; id < words.size(); id++){
+            unsigned int h = hash(words.get(id));
+            int slot = h & mask;
+            while(newSlots[slot] != -1) slot = (slot + 1) & mask;
+            newSlots[slot] = id;
+            newSlotHashes[slot] = h;
+        }
+    }
+
+    //Delete the old table and switch to the new one
+    delete[] slots;
+    delete[] slotHashes;
+    slots = newSlots;
+    slotHashes = newSlotHashes;
+    capacity = newCapacity;
+}
+
+/*
+Probes the table for a word, starting at the slot picked by its hash
+@param h - the hash of the word
+@param word - the word to find
+@return - the slot holding the word, or the empty slot where it would be inserted
+*/
+int Dictionary::findSlot(unsigned int h, char* word){
+    int mask = capacity - 1;
+    int slot = h & mask;
+
+    //Move forward until the word or an empty slot is found. Only words with the same hash are compared
+    while(slots[slot] != -1){
+        if(slotHashes[slot] == h && strcmp(words.get(slots[slot]), word) == 0) return slot;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/*
+Looks up a single word
+@param word - the lower case cstring to look up
+@return - the id of the word, or -1 if it isn't in the dictionary
+*/
+int Dictionary::lookup(char* word){
+    return slots[findSlot(hash(word), word)];
+}
+
+/*
+Looks up a batch of words, adding any that are new to the end of the word list.
+The lookups happen in three passes so that the cache misses of the batch overlap: the first hashes every word and prefetches
+its slot, the second prefetches the word each slot points to, and the third probes the table and inserts the new words.
+Words are resolved in order, so a new word that appears twice in the batch is inserted once and found the second time
+PRECONDITION: every word is a lower case cstring in a buffer of at least 41 chars, as required by ArrayList::add, and count <= DICTIONARY_BATCH
+@param batch - the words to look up
+@param count - the number of words in the batch
+@param ids - filled with the id of each word
+@param inserted - filled with whether each word was new and has just been added
+*/
+void Dictionary::lookupOrInsert(char** batch, int count, int* ids, bool* inserted){
+
+    //Grow the table before starting, so it stays under half full and the prefetched slots stay where they are
+    while((words.size() + count) * 2 > capacity) resize(capacity * 2);
+    int mask = capacity - 1;
+
+    //Hash every word and prefetch its first slot and that slot's hash
+    unsigned int hashes[DICTIONARY_BATCH];
+    for(int i = 0; i < count; i++){
+        hashes[i] = hash(batch[i]);
+        __builtin_prefetch(&slots[hashes[i] & mask]);
+        __builtin_prefetch(&slotHashes[hashes[i] & mask]);
+    }
+
+    //Prefetch the word held by each first slot, which is where the comparison will happen
+    for(int i = 0; i < count; i++){
+        int id = slots[hashes[i] & mask];
+        if(id != -1) __builtin_prefetch(words.get(id));
+    }
+
+    //Resolve every word, inserting the ones that weren't found
+    for(int i = 0; i < count; i++){
+        int slot = findSlot(hashes[i], batch[i]);
+        inserted[i] = (slots[slot] == -1);
+        if(inserted[i]){
+            slots[slot] = words.size();
+            slotHashes[slot] = hashes[i];
+            words.add(batch[i]);
+        }
+        ids[i] = slots[slot];
+    }
+}
+
+/*
+Destructor for Dictionary, deletes the table. The words belong to the word list and are left alone
+*/
+Dictionary::~Dictionary(){
+    delete[] slots;
+    delete[] slotHashes;
+}
@@ -0,0 +1,36 @@
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+#include "ArrayList.h"
+
+//The most words that can be looked up in one call to lookupOrInsert
+#define DICTIONARY_BATCH 32
+//The number of slots in a new dictionary. Must be a power of two
+#define DICTIONARY_START_CAPACITY 64
+
+/*
+ * The Dictionary class is an open addressing hash table from words to their ids, where a word's id is its index in an ArrayList.
+ * Words are looked up in batches: every word in the batch is hashed and its slot prefetched before any of them is resolved,
+ * so that the cache misses of the whole batch overlap instead of being waited on one word at a time
+ */
+class Dictionary
+{
+private:
+    ArrayList& words; //The list holding the words. New words are added to the end of it
+    int* slots; //Id of the word in each slot, or -1 for an empty slot
+    unsigned int* slotHashes; //Hash of the word in each slot, checked before comparing the words themselves
+    int capacity; //Number of slots. Always a power of two
+    void resize(int); //Rehashes every word into a table with the given number of slots
+    int findSlot(unsigned int, char*); //Finds the slot holding a word, or the empty slot where it belongs
+
+public:
+    Dictionary(ArrayList&); //Constructor, takes the list of words the ids refer to
+    Dictionary(const Dictionary&) = delete;
+    Dictionary& operator=(const Dictionary&) = delete;
+    ~Dictionary(); //Destructor
+    static unsigned int hash(const char*); //Hashes a cstring
+    int lookup(char*); //Gets the id of a word, or -1 if it isn't in the dictionary
+    void lookupOrInsert(char**, int, int*, bool*); //Gets the ids of a batch of words, adding the ones that are new
+};
+
+#endif
@@ -0,0 +1,534 @@
+#include "indexdaemon.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cctype>
+#include <climits>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "snapshotreader.h"
+
+using namespace std;
+
+/*
+Helper method - reads the argument of a command that takes a number. A number too big for an int is clamped
+to INT_MAX, the same way Tokenizer clamps <n> page markers
+@param text - the argument, which must be nothing but decimal digits
+@param number - set to the number read
+@return - false if the argument isn't a non-negative number
+*/
+static bool parseNumber(char* text, int& number){
+    if(!isdigit((unsigned char)text[0])) return false;
+    char* end;
+    long value = strtol(text, &end, 10);
+    if(*end != '\0') return false;
+
+    //strtol saturates at LONG_MAX when the digits overflow a long, which is clamped along with anything past INT_MAX
+    number = (value > INT_MAX)? INT_MAX: (int)value;
+    return true;
+}
+
+/*
+Constructor for an IndexDaemon. Nothing is opened until run is called
+@param path - the file system path of the unix socket to listen on
+*/
+IndexDaemon::IndexDaemon(char* path)
+{
+    socketPath = path;
+    listenFd = -1;
+    running = false;
+
+    //Start with room for RESIZE_FACTOR indexes and RESIZE_FACTOR clients
+    indexes = new ServedIndex*[RESIZE_FACTOR];
+    numIndexes = 0;
+    capacity = RESIZE_FACTOR;
+    clients = new ClientConnection*[RESIZE_FACTOR];
+    numClients = 0;
+    clientCapacity = RESIZE_FACTOR;
+}
+
+/*
+Finds the index with the given name, creating an empty one if no index has that name yet.
+Indexes created by the daemon publish snapshots, so that they can be queried while a LOAD is running
+@param name - the name of the index, kept in full
+@return - the index. It stays in place until the daemon is destroyed, even while other indexes are created
+*/
+ServedIndex* IndexDaemon::getIndex(char* name){
+
+    lock_guard<mutex> guard(namesLock);
+
+    //Return the index if it already exists
+    for(int i = 0; i < numIndexes; i++)
+        if(strcmp(indexes[i]->name, name) == 0) return indexes[i];
+
+    //Grow the array of indexes if it is full
+    if(numIndexes == capacity){
+        ServedIndex** temp = new ServedIndex*[capacity + RESIZE_FACTOR];
+        for(int i = 0; i < numIndexes; i++)
+            temp[i] = indexes[i];
+        delete[] indexes;
+        indexes = temp;
+        capacity += RESIZE_FACTOR;
+    }
+
+    //Register the new index under its name
+    ServedIndex* served = new ServedIndex();
+    served->name = new char[strlen(name) + 1];
+    strcpy(served->name, name);
+    served->index = new AutoIndex();
+    served->index->enableSnapshots();
+    served->loader = nullptr;
+    served->snapshotReaders = 0;
+    indexes[numIndexes++] = served;
+    return served;
+}
+
+/*
+Checks whether a LOAD into an index is still running. The caller must hold the index's lock
+@param served - the index
+@return - true if a thread is still reading a file into the index
+*/
+bool IndexDaemon::isLoading(ServedIndex* served){
+    return served->loader != nullptr && !served->loader->done;
+}
+
+/*
+Waits for the last LOAD into an index to finish and cleans up after it. Does nothing if no LOAD was started.
+The caller must hold the index's lock unless no other thread can be using the index
+@param served - the index
+*/
+void IndexDaemon::finishLoad(ServedIndex* served){
+    if(served->loader == nullptr) return;
+    served->loader->thread.join();
+    delete served->loader;
+    served->loader = nullptr;
+}
+
+/*
+Swaps an index for an empty one, so that its name stays registered. Clients that let go of the lock to read
+snapshots of the old index may still be reading, so the old index is only deleted once the last of them is done.
+The caller must hold the index's lock, which keeps any new reader from starting
+@param served - the index
+*/
+void IndexDaemon::replaceIndex(ServedIndex* served){
+    finishLoad(served);
+    while(served->snapshotReaders > 0)
+        this_thread::yield();
+    delete served->index;
+    served->index = new AutoIndex();
+    served->index->enableSnapshots();
+}
+
+/*
+Executes a single command line from a client, writing the reply to a stream
+@param line - the command line, without its line ending
+@param current - the index the client is working on. USE changes it
+@param reply - the stream the reply is written to
+@return - false if the connection should be closed after the reply is sent
+*/
+bool IndexDaemon::execute(char* line, ServedIndex*& current, ostream& reply){
+
+    //Split the command from its argument, which is everything after the first space
+    char* argument = strchr(line, ' ');
+    if(argument != nullptr){
+        *argument = '\0';
+        argument++;
+    } else {
+        argument = line + strlen(line);
+    }
+
+    //Commands that don't touch the current index
+    if(strcmp(line, "USE") == 0){
+        if(argument[0] == '\0'){
+            reply << "ERR missing index name" << endl;
+        } else {
+            current = getIndex(argument);
+            reply << "OK" << endl;
+        }
+        return true;
+    } else if(strcmp(line, "LIST") == 0){
+        lock_guard<mutex> guard(namesLock);
+        for(int i = 0; i < numIndexes; i++)
+            reply << indexes[i]->name << endl;
+        reply << "END" << endl;
+        return true;
+    } else if(strcmp(line, "QUIT") == 0){
+        reply << "OK" << endl;
+        return false;
+    } else if(strcmp(line, "SHUTDOWN") == 0){
+        running = false;
+        reply << "OK" << endl;
+        return false;
+    }
+
+    //Every other command works on the current index while holding its lock
+    unique_lock<mutex> lock(current->lock);
+    AutoIndex* index = current->index;
+
+    //While a LOAD is running, its thread is the only one allowed to change or read the index directly
+    bool loading = isLoading(current);
+    if(loading && (strcmp(line, "ADD") == 0 || strcmp(line, "PAGE") == 0 || strcmp(line, "LOAD") == 0 || strcmp(line, "DOC") == 0
+                   || strcmp(line, "DOCS") == 0 || strcmp(line, "OUTPUT") == 0 || strcmp(line, "SECTION") == 0 || strcmp(line, "CLEAR") == 0)){
+        reply << "ERR busy loading" << endl;
+        return true;
+    }
+
+    //Lookups during a LOAD answer from the latest snapshot, so they let go of the lock instead of holding up other clients.
+    //Counting them as snapshot readers keeps CLEAR from deleting the index under them
+    bool readingSnapshot = loading && (strcmp(line, "TERM") == 0 || strcmp(line, "TERMIN") == 0 || strcmp(line, "PREFIX") == 0);
+    if(readingSnapshot){
+        current->snapshotReaders++;
+        lock.unlock();
+    }
+
+    if(strcmp(line, "ADD") == 0){
+        //The line ending is fed too, so a word at the end of the line is finished but an open [phrase] carries on into the next ADD
+        index->feed(argument, strlen(argument));
+        index->feed("\n", 1);
+        reply << "OK" << endl;
+    } else if(strcmp(line, "PAGE") == 0){
+        int page;
+        if(!parseNumber(argument, page)){
+            reply << "ERR bad page" << endl;
+        } else {
+            index->setPage(page);
+            reply << "OK" << endl;
+        }
+    } else if(strcmp(line, "DOC") == 0){
+        if(argument[0] == '\0'){
+            reply << "ERR missing document name" << endl;
+        } else if(!index->beginDocument(argument)){
+            reply << "ERR duplicate document name " << argument << endl;
+        } else {
+            reply << "OK" << endl;
+        }
+    } else if(strcmp(line, "DOCS") == 0){
+        for(int i = 0; i < index->getNumberOfDocuments(); i++)
+            reply << index->getDocumentName(i) << endl;
+        reply << "END" << endl;
+    } else if(strcmp(line, "LOAD") == 0){
+
+        //Open the file here so that a bad path can be reported, then hand it to a thread that reads it into the index
+        ifstream* file = new ifstream(argument);
+        if(!file->is_open()){
+            delete file;
+            reply << "ERR cannot open " << argument << endl;
+        } else {
+
+            //Publish what was added before the LOAD, so lookups during it see that too
+            finishLoad(current);
+            index->publishSnapshot();
+            IndexLoader* loader = new IndexLoader();
+            loader->done = false;
+            ServedIndex* served = current;
+            loader->thread = thread([served, index, file, loader](){
+                index->read(*file);
+                delete file;
+                lock_guard<mutex> guard(served->lock);
+                loader->done = true;
+                served->loadFinished.notify_all();
+            });
+            current->loader = loader;
+            reply << "OK" << endl;
+        }
+    } else if(strcmp(line, "WAIT") == 0){
+
+        //The lock is let go of while waiting, so other clients can keep reading snapshots
+        ServedIndex* served = current;
+        current->loadFinished.wait(lock, [this, served](){ return !isLoading(served); });
+        finishLoad(current);
+        reply << "OK" << endl;
+    } else if(strcmp(line, "TERM") == 0){
+
+        //Look the word up in the latest snapshot while loading, and in the index itself otherwise
+        if(readingSnapshot){
+            SnapshotReader reader(*index);
+            const IndexSnapshot* snapshot = reader.acquire();
+            int id = (snapshot == nullptr)? -1: snapshot->indexOf(argument);
+            if(id == -1){
+                reply << "NONE" << endl;
+            } else {
+                reply << "OK ";
+                snapshot->writeTerm(id, reply);
+            }
+        } else {
+            int id = index->indexOf(argument);
+            if(id == -1){
+                reply << "NONE" << endl;
+            } else {
+                reply << "OK ";
+                index->writeTerm(id, reply);
+            }
+        }
+    } else if(strcmp(line, "TERMIN") == 0){
+
+        //Split the document name from the word, then look the word up only in that document's block
+        char* word = strchr(argument, ' ');
+        if(word == nullptr){
+            reply << "ERR missing word" << endl;
+        } else if(readingSnapshot){
+            *word = '\0';
+            word++;
+            SnapshotReader reader(*index);
+            const IndexSnapshot* snapshot = reader.acquire();
+            int id = (snapshot == nullptr)? -1: snapshot->indexOf(word);
+            int document = (snapshot == nullptr)? -1: snapshot->indexOfDocument(argument);
+            if(id == -1 || document == -1 || snapshot->getView(id).findBlock(document) == -1){
+                reply << "NONE" << endl;
+            } else {
+                reply << "OK ";
+                snapshot->writeTermInDocument(id, document, reply);
+            }
+        } else {
+            *word = '\0';
+            word++;
+            int id = index->indexOf(word);
+            int document = index->indexOfDocument(argument);
+            if(id == -1 || document == -1 || index->getView(id).findBlock(document) == -1){
+                reply << "NONE" << endl;
+            } else {
+                reply << "OK ";
+                index->writeTermInDocument(id, document, reply);
+            }
+        }
+    } else if(strcmp(line, "PREFIX") == 0){
+        if(readingSnapshot){
+            SnapshotReader reader(*index);
+            const IndexSnapshot* snapshot = reader.acquire();
+            if(snapshot != nullptr) snapshot->writePrefix(argument, reply);
+        } else {
+            index->writePrefix(argument, reply);
+        }
+        reply << "END" << endl;
+    } else if(strcmp(line, "OUTPUT") == 0){
+        int maxTerms = -1;
+        if(argument[0] != '\0' && !parseNumber(argument, maxTerms)){
+            reply << "ERR bad count" << endl;
+        } else {
+            index->write(reply, maxTerms);
+            reply << "END" << endl;
+        }
+    } else if(strcmp(line, "SECTION") == 0){
+        if(argument[0] != '\0') index->writeSection(argument[0], reply);
+        reply << "END" << endl;
+    } else if(strcmp(line, "CLEAR") == 0){
+        replaceIndex(current);
+        reply << "OK" << endl;
+    } else {
+        reply << "ERR unknown command " << line << endl;
+    }
+
+    if(readingSnapshot) current->snapshotReaders--;
+    return true;
+}
+
+/*
+Reads command lines from a connected client and sends back the reply to each, until the client
+disconnects or asks to quit. The socket is left open for the thread that joins this one to close
+@param clientFd - the connected socket of the client
+*/
+void IndexDaemon::serveClient(int clientFd){
+
+    //Every connection starts on the default index
+    ServedIndex* current = getIndex((char*)"default");
+
+    char* buffer = new char[DAEMON_LINE_MAX];
+    int used = 0; //Number of bytes of buffer holding data that hasn't been executed yet
+    bool discarding = false; //Set while skipping the rest of a line that was too long
+    bool open = true;
+
+    while(open){
+
+        //Receive more data from the client, stopping when it disconnects
+        ssize_t received = recv(clientFd, buffer + used, DAEMON_LINE_MAX - used, 0);
+        if(received <= 0) break;
+        used += received;
+
+        //Execute every complete line in the buffer
+        int lineStart = 0;
+        for(int i = 0; i < used && open; i++){
+            if(buffer[i] != '\n') continue;
+
+            //End the line, dropping a carriage return if the client sent one
+            buffer[i] = '\0';
+            if(i > lineStart && buffer[i-1] == '\r') buffer[i-1] = '\0';
+
+            //Execute the line unless it is the end of a line that was too long, and send the reply
+            if(!discarding){
+                ostringstream reply;
+                open = execute(buffer + lineStart, current, reply);
+                string text = reply.str();
+                size_t sent = 0;
+                while(sent < text.size()){
+                    ssize_t result = send(clientFd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+                    if(result <= 0){
+                        open = false;
+                        break;
+                    }
+                    sent += result;
+                }
+            }
+            discarding = false;
+            lineStart = i + 1;
+        }
+
+        //Move the incomplete line left in the buffer to the front
+        memmove(buffer, buffer + lineStart, used - lineStart);
+        used -= lineStart;
+
+        //If a whole buffer holds no line ending, the line is too long to execute. Reject it and skip to its end
+        if(used == DAEMON_LINE_MAX){
+            const char* error = "ERR line too long\n";
+            send(clientFd, error, strlen(error), MSG_NOSIGNAL);
+            discarding = true;
+            used = 0;
+        }
+    }
+
+    delete[] buffer;
+
+    //After the reply to a SHUTDOWN has been sent, wake the accepting thread so that it sees the daemon is no longer running
+    if(!running) shutdown(listenFd, SHUT_RDWR);
+}
+
+/*
+Starts a thread that serves a newly connected client
+@param clientFd - the connected socket of the client
+*/
+void IndexDaemon::addClient(int clientFd){
+
+    //Grow the array of clients if it is full
+    if(numClients == clientCapacity){
+        ClientConnection** temp = new ClientConnection*[clientCapacity + RESIZE_FACTOR];
+        for(int i = 0; i < numClients; i++)
+            temp[i] = clients[i];
+        delete[] clients;
+        clients = temp;
+        clientCapacity += RESIZE_FACTOR;
+    }
+
+    ClientConnection* client = new ClientConnection();
+    client->fd = clientFd;
+    client->done = false;
+    client->thread = thread([this, client](){
+        serveClient(client->fd);
+        client->done = true;
+    });
+    clients[numClients++] = client;
+}
+
+/*
+Joins the threads of clients that have disconnected and closes their sockets
+@param all - if true, every client still connected is disconnected first, so that every thread is joined
+*/
+void IndexDaemon::reapClients(bool all){
+    int kept = 0;
+    for(int i = 0; i < numClients; i++){
+        ClientConnection* client = clients[i];
+        if(!all && !client->done){
+            clients[kept++] = client;
+            continue;
+        }
+
+        //Shutting the socket down wakes a thread waiting on the client, which then sees it disconnect
+        if(!client->done) shutdown(client->fd, SHUT_RDWR);
+        client->thread.join();
+        close(client->fd);
+        delete client;
+    }
+    numClients = kept;
+}
+
+/*
+Makes the socket path free to bind. A socket left behind by a daemon that didn't shut down cleanly is removed,
+but a path holding anything else, or a socket another daemon is still listening on, is left alone
+@param address - the socket address built from the socket path
+@return - true if the path is free to bind
+*/
+bool IndexDaemon::claimPath(const sockaddr_un& address){
+    struct stat info;
+    if(lstat(socketPath, &info) == -1) return true;
+    if(!S_ISSOCK(info.st_mode)){
+        cerr << socketPath << " already exists and is not a socket" << endl;
+        return false;
+    }
+
+    //A socket nobody accepts connections on is left over from an earlier daemon
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    bool listening = probe != -1 && connect(probe, (const sockaddr*)&address, sizeof(address)) == 0;
+    if(probe != -1) close(probe);
+    if(listening){
+        cerr << "A daemon is already listening on " << socketPath << endl;
+        return false;
+    }
+    unlink(socketPath);
+    return true;
+}
+
+/*
+Opens the socket and serves clients, each on a thread of its own, until one of them sends SHUTDOWN
+@return - 0 after a clean shutdown, 1 if the socket could not be opened
+*/
+int IndexDaemon::run(){
+
+    //Make sure the path fits in a socket address
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(strlen(socketPath) >= sizeof(address.sun_path)){
+        cerr << "Socket path is too long: " << socketPath << endl;
+        return 1;
+    }
+    strcpy(address.sun_path, socketPath);
+
+    //Replace a socket left behind by an earlier daemon, then bind and listen
+    if(!claimPath(address)) return 1;
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listenFd == -1 || bind(listenFd, (sockaddr*)&address, sizeof(address)) == -1 || listen(listenFd, 16) == -1){
+        perror(socketPath);
+        if(listenFd != -1) close(listenFd);
+        listenFd = -1;
+        return 1;
+    }
+
+    //Serve clients until one asks for a shutdown, cleaning up after the ones that left each time another connects
+    running = true;
+    while(running){
+        int clientFd = accept(listenFd, nullptr, nullptr);
+        if(clientFd == -1) continue;
+        if(!running){
+            close(clientFd);
+            break;
+        }
+        reapClients(false);
+        addClient(clientFd);
+    }
+
+    //Disconnect every client, then close and remove the socket
+    reapClients(true);
+    close(listenFd);
+    listenFd = -1;
+    unlink(socketPath);
+    return 0;
+}
+
+/*
+Destructor for IndexDaemon, waits for every LOAD to finish and deletes every index being served
+*/
+IndexDaemon::~IndexDaemon(){
+    for(int i = 0; i < numIndexes; i++){
+        finishLoad(indexes[i]);
+        delete indexes[i]->index;
+        delete[] indexes[i]->name;
+        delete indexes[i];
+    }
+    delete[] indexes;
+    delete[] clients;
+}
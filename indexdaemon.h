@@ -0,0 +1,120 @@
+#ifndef INDEXDAEMON_H
+#define INDEXDAEMON_H
+
+#include <ostream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <sys/un.h>
+
+#include "ArrayList.h"
+#include "autoindex.h"
+
+//The longest command line, in bytes, that a client can send
+#define DAEMON_LINE_MAX 65536
+
+/*
+ * The IndexLoader struct tracks a LOAD running in the background
+ */
+struct IndexLoader
+{
+    std::thread thread; //Thread reading the file into the index
+    bool done; //Set by the thread, holding the index's lock, once the file has been read
+};
+
+/*
+ * The ServedIndex struct holds one named index along with what the daemon needs to share it between clients
+ */
+struct ServedIndex
+{
+    char* name; //The name the index is used by, kept in full
+    AutoIndex* index; //The index itself, replaced by an empty one on CLEAR
+    IndexLoader* loader; //The last LOAD started into the index, or nullptr
+    std::mutex lock; //Held while a client changes or reads the index directly
+    std::condition_variable loadFinished; //Notified when a LOAD into the index finishes
+    std::atomic<int> snapshotReaders; //Number of clients reading snapshots of the index without holding its lock
+};
+
+/*
+ * The ClientConnection struct tracks one connected client and the thread serving it
+ */
+struct ClientConnection
+{
+    std::thread thread; //Thread reading and executing the client's commands
+    int fd; //Connected socket of the client, closed once the thread has been joined
+    std::atomic<bool> done; //Set by the thread once the client has disconnected
+};
+
+/*
+ * The IndexDaemon class keeps named indexes in memory and serves them to clients over a unix domain socket.
+ * Clients send one command per line and get back either a single "OK ...", "NONE" or "ERR ..." line,
+ * or, for commands that list terms, the listed lines followed by a line reading "END".
+ *
+ *   USE name      - switch to the named index, creating it if needed (every connection starts on "default").
+ *                   Names are compared in full, whatever their length
+ *   ADD text      - read words, [phrases] and <n> page markers from the rest of the line into the index.
+ *                   A phrase left open at the end of the line carries on into the next ADD
+ *   PAGE n        - set the page that following words are registered on. Pages past the largest int are clamped to it,
+ *                   and anything but a non-negative number gets "ERR bad page"
+ *   DOC name      - start a new document, turning the index into a corpus. Following words are registered in it from page 0.
+ *                   A name already used by another document of the index gets "ERR duplicate document name"
+ *   LOAD path     - read a file into the index in the background. While it loads, TERM and PREFIX answer from the
+ *                   latest snapshot of the partial index, which trails the LOAD by at most the lag described for
+ *                   SNAPSHOT_MIN_WORDS in autoindex.h, and commands that change or format the index get "ERR busy"
+ *   WAIT          - wait for a LOAD into the current index to finish
+ *   TERM word     - get the pages a word or phrase appeared on, as "OK word: 1, 2, 3" or "NONE".
+ *                   In a corpus the pages are grouped by document, as "OK word: doc1: 1, 2; doc2: 3"
+ *   TERMIN doc word - get the pages a word or phrase appeared on in one document of a corpus, as "OK word: 1, 2" or "NONE"
+ *   PREFIX text   - list every term starting with text, in alphabetical order
+ *   OUTPUT [n]    - list the formatted index exactly as Exec would write it to a file, or only its first n terms.
+ *                   Anything but a non-negative number for n gets "ERR bad count"
+ *   SECTION c     - list the formatted section of terms starting with the character c
+ *   CLEAR         - empty the current index
+ *   LIST          - list the names of every index
+ *   DOCS          - list the names of the documents in the current index
+ *   QUIT          - close the connection
+ *   SHUTDOWN      - close the connection and stop the daemon
+ *
+ * Every client is served on a thread of its own, so a client that stays connected never holds up the others.
+ * Each index has a lock, held by a client for the whole of a command that changes the index (ADD, PAGE, DOC, LOAD, CLEAR)
+ * or reads it directly (TERM, TERMIN, PREFIX, OUTPUT, SECTION, DOCS). Commands on different indexes never wait on each other,
+ * and commands on the same index run one at a time. While a LOAD is running, its thread owns the index instead: TERM, TERMIN
+ * and PREFIX take the lock only long enough to see that, then answer from the latest snapshot without holding it, so a
+ * reader on another connection keeps getting answers during the whole LOAD. WAIT sleeps until the LOAD is done without
+ * holding the lock. The list of index names has a lock of its own, held by USE and LIST.
+ * The daemon refuses to start on a path that holds anything but a socket, or a socket another daemon is listening on
+ */
+
+class IndexDaemon
+{
+private:
+    char* socketPath; //File system path of the socket the daemon listens on
+    int listenFd; //Listening socket, or -1 if the daemon isn't running
+    std::atomic<bool> running; //Set to false to stop accepting connections
+    std::mutex namesLock; //Held while the list of indexes is read or grown
+    ServedIndex** indexes; //Indexes being served, all with different names
+    int numIndexes; //Number of pointers in use in the indexes array
+    int capacity; //Number of pointers in the indexes array
+    ClientConnection** clients; //Clients connected, or that disconnected since the last accept
+    int numClients; //Number of pointers in use in the clients array
+    int clientCapacity; //Number of pointers in the clients array
+    ServedIndex* getIndex(char*); //Finds the index with a name, creating it if needed
+    bool isLoading(ServedIndex*); //Checks whether a LOAD into an index is still running
+    void finishLoad(ServedIndex*); //Waits for the last LOAD into an index to finish
+    void replaceIndex(ServedIndex*); //Swaps an index for an empty one once no client is reading its snapshots
+    bool claimPath(const sockaddr_un&); //Removes a socket left behind at the socket path, refusing anything else
+    void addClient(int); //Starts a thread serving a newly connected client
+    void reapClients(bool); //Joins the threads of disconnected clients, or of every client
+    void serveClient(int); //Reads and executes commands from one client until it disconnects
+    bool execute(char*, ServedIndex*&, std::ostream&); //Executes one command line, returning false once the connection should close
+
+public:
+    IndexDaemon(char*); //Constructor, takes the path of the socket to listen on
+    IndexDaemon(const IndexDaemon&) = delete;
+    IndexDaemon& operator=(const IndexDaemon&) = delete;
+    ~IndexDaemon(); //Destructor, deletes every index
+    int run(); //Listens for clients until a SHUTDOWN command, returning the process exit status
+};
+
+#endif
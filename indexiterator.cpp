@@ -0,0 +1,146 @@
+#include "indexiterator.h"
+
+#include <climits>
+#include <algorithm>
+
+int strCompare(char*, char*); //Compare the alphabetical order of two cstrings
+
+/*
+Helper method - gets the section a term belongs to from its first character.
+Sections are numbered in the same order strCompare puts their characters in
+@param firstChar - the first character of the term
+@return - the section number, from 0 to NUM_SECTIONS-1
+*/
+static int sectionOf(char firstChar){
+    return (int)firstChar - CHAR_MIN;
+}
+
+/*
+Constructor for an IndexIterator. Groups the ids of every term by section in one pass, without sorting anything
+@param source - the index to walk. Any words still waiting in its batch are registered first
+*/
+IndexIterator::IndexIterator(AutoIndex& source)
+{
+    index = &source;
+    index->flush();
+    order = new int[index->size()];
+    position = -1;
+    section = 0;
+
+    //Count the terms in each section
+    int counts[NUM_SECTIONS] = {0};
+    for(int i = 0; i < index->size(); i++)
+        counts[sectionOf(index->getTerm(i)[0])]++;
+
+    //Turn the counts into the position where each section starts
+    sectionStart[0] = 0;
+    for(int s = 0; s < NUM_SECTIONS; s++){
+        sectionStart[s+1] = sectionStart[s] + counts[s];
+        sectionSorted[s] = false;
+    }
+
+    //Drop every id into the next free slot of its section
+    int fill[NUM_SECTIONS];
+    for(int s = 0; s < NUM_SECTIONS; s++)
+        fill[s] = sectionStart[s];
+    for(int i = 0; i < index->size(); i++)
+        order[fill[sectionOf(index->getTerm(i)[0])]++] = i;
+}
+
+/*
+Sorts the ids in one section alphabetically by their terms
+@param s - the section to sort
+*/
+void IndexIterator::sortSection(int s){
+
+    //Sort the ids of the section in place, comparing the terms they stand for
+    AutoIndex* source = index;
+    std::sort(order + sectionStart[s], order + sectionStart[s+1], [source](int a, int b){
+        return strCompare(source->getTerm(a), source->getTerm(b)) < 0;
+    });
+
+    sectionSorted[s] = true;
+}
+
+/*
+Moves the iterator to the next term in alphabetical order, sorting its section first if this is the first time the section was reached
+@return - true if the iterator is on a term, false if every term has been visited
+*/
+bool IndexIterator::next(){
+
+    //Stay past the end once every term has been visited
+    if(position >= index->size()) return false;
+    position++;
+
+    //Skip over the section boundaries up to the section holding the new position
+    while(section < NUM_SECTIONS && position >= sectionStart[section+1]) section++;
+    if(section == NUM_SECTIONS) return false;
+
+    if(!sectionSorted[section]) sortSection(section);
+    return true;
+}
+
+/*
+Moves the iterator to just before the first term starting with a character. If no term starts with it,
+the next call to next moves to the first term of a later section instead
+@param firstChar - the first character of the section to move to
+*/
+void IndexIterator::seekSection(char firstChar){
+    section = sectionOf(firstChar);
+    position = sectionStart[section] - 1;
+}
+
+/*
+Checks whether the current term is the first one of its section, which is where a section heading belongs
+@return - true if the current term is the first of its section
+*/
+bool IndexIterator::startsSection() const{
+    return position == sectionStart[section];
+}
+
+/*
+Gets the first character shared by every term in the current section
+@return - the first character of the current term
+*/
+char IndexIterator::getSectionChar() const{
+    return (char)(section + CHAR_MIN);
+}
+
+/*
+Getter for the id of the current term, as used by the AutoIndex
+@return - the id of the current term
+*/
+int IndexIterator::getTermId() const{
+    return order[position];
+}
+
+/*
+Gets the current term
+@return - the lower case cstring of the current term
+*/
+char* IndexIterator::getTerm() const{
+    return index->getTerm(order[position]);
+}
+
+/*
+Gets a view of the pages on which the current term appeared. The view stays valid until the index is modified
+@return - a pointer to getPageCount() page numbers, in increasing order within each document
+*/
+const int* IndexIterator::getPages() const{
+    return index->getPages(order[position]);
+}
+
+/*
+Gets the number of pages on which the current term appeared
+@return - the number of pages in the view returned by getPages
+*/
+int IndexIterator::getPageCount() const{
+    return index->getPageCount(order[position]);
+}
+
+/*
+Destructor for IndexIterator, deletes the ordering of the ids
+*/
+IndexIterator::~IndexIterator(){
+    delete[] order;
+}
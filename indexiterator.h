@@ -0,0 +1,41 @@
+#ifndef INDEXITERATOR_H
+#define INDEXITERATOR_H
+
+#include "autoindex.h"
+
+//The number of distinct first characters, and therefore the most sections an index can have
+#define NUM_SECTIONS 256
+
+/*
+ * The IndexIterator class walks the terms of an AutoIndex in alphabetical order, one term at a time.
+ * Terms are grouped by first character up front, but each section is only sorted when the iterator reaches it,
+ * so asking for the first few terms or a single section doesn't pay for sorting the whole index.
+ * The index must not be modified while an iterator over it is in use
+ */
+class IndexIterator
+{
+private:
+    AutoIndex* index; //The index being walked
+    int* order; //Term ids grouped by section, each section sorted once it has been reached
+    int sectionStart[NUM_SECTIONS + 1]; //order[sectionStart[s]..sectionStart[s+1]) holds the ids of section s
+    bool sectionSorted[NUM_SECTIONS]; //Whether each section has been sorted yet
+    int position; //Position in order of the current term, -1 before the first call to next
+    int section; //Section of the current term
+    void sortSection(int); //Sorts the ids of one section alphabetically
+
+public:
+    IndexIterator(AutoIndex&); //Constructor, starts before the first term of the index
+    IndexIterator(const IndexIterator&) = delete;
+    IndexIterator& operator=(const IndexIterator&) = delete;
+    ~IndexIterator(); //Destructor
+    bool next(); //Moves to the next term, returning false once every term has been visited
+    void seekSection(char); //Moves to just before the first term starting with a character
+    bool startsSection() const; //Whether the current term is the first of its section
+    char getSectionChar() const; //Gets the first character shared by every term in the current section
+    int getTermId() const; //Gets the id of the current term in the index
+    char* getTerm() const; //Gets the current term
+    const int* getPages() const; //Gets the sorted pages on which the current term appeared
+    int getPageCount() const; //Gets the number of pages on which the current term appeared
+};
+
+#endif
@@ -0,0 +1,181 @@
+#include "indexsnapshot.h"
+#include "dictionary.h"
+
+#include <cstring>
+#include <cctype>
+
+using namespace std;
+
+/*
+Constructor for an IndexSnapshot. The chunks, hash table and document names are built by a SnapshotStore, which keeps them
+alive for as long as the snapshot. Only the lists of pointers to the chunks and names are copied
+@param numTerms - the number of terms in the snapshot
+@param termChunks - the chunks of term headers, enough for numTerms terms
+@param numChunks - the number of chunks in termChunks
+@param table - the hash table from each term to its id
+@param tableCapacity - the number of slots in the hash table
+@param names - the names of the documents in the corpus
+@param numDocuments - the number of names
+*/
+IndexSnapshot::IndexSnapshot(int numTerms, SnapshotTerm** termChunks, int numChunks, const atomic<int>* table, int tableCapacity,
+                             char** names, int numDocuments)
+{
+    nextRetired = nullptr;
+    retireEpoch = 0;
+    termCount = numTerms;
+
+    //Copy the lists of chunks and names, since the store moves on to newer ones
+    chunks = new SnapshotTerm*[numChunks];
+    for(int i = 0; i < numChunks; i++)
+        chunks[i] = termChunks[i];
+    documentCount = numDocuments;
+    documentNames = new char*[numDocuments];
+    for(int i = 0; i < numDocuments; i++)
+        documentNames[i] = names[i];
+
+    slots = table;
+    capacity = tableCapacity;
+}
+
+/*
+Helper method - gets the header of a term from its chunk
+@param id - the id of the term
+@return - the header holding the term, its pages and its skip list
+*/
+const SnapshotTerm& IndexSnapshot::header(int id) const{
+    return chunks[id / SNAPSHOT_CHUNK][id % SNAPSHOT_CHUNK];
+}
+
+/*
+Calculates the id of a word in the snapshot. The lookup ignores case and anything past 40 characters
+@param word - the cstring to look up
+@return - the id of the word, or -1 if it doesn't appear in the snapshot
+*/
+int IndexSnapshot::indexOf(char* word) const{
+
+    //Move the word to a lower case cstring so it can be compared against the saved terms
+    char key[41] = {0};
+    for(int i = 0; i < 40 && word[i] != '\0'; i++)
+        key[i] = tolower((unsigned char)word[i]);
+
+    //Probe the table until the word or an empty slot is found. The table is shared with newer snapshots,
+    //so slots holding terms added after this snapshot are passed over like any other term
+    int slot = Dictionary::hash(key) & (capacity - 1);
+    int id;
+    while((id = slots[slot].load(memory_order_relaxed)) != -1){
+        if(id < termCount && strcmp(getTerm(id), key) == 0) return id;
+        slot = (slot + 1) & (capacity - 1);
+    }
+    return -1;
+}
+
+/*
+Getter for the number of terms in the snapshot
+@return - the number of terms
+*/
+int IndexSnapshot::size() const{
+    return termCount;
+}
+
+/*
+Gets the term with the given id. Ids are the same as in the index the snapshot was taken from
+@param id - the id of the term
+@return - the lower case cstring for that term
+*/
+char* IndexSnapshot::getTerm(int id) const{
+    return header(id).term;
+}
+
+/*
+Gets the pages on which a term appeared
+@param id - the id of the term
+@return - a pointer to getPageCount(id) page numbers, in increasing order within each document, valid for as long as the snapshot is
+*/
+const int* IndexSnapshot::getPages(int id) const{
+    return header(id).pages;
+}
+
+/*
+Gets the number of pages on which a term appeared
+@param id - the id of the term
+@return - the number of pages saved for that term
+*/
+int IndexSnapshot::getPageCount(int id) const{
+    return header(id).pageCount;
+}
+
+/*
+Checks whether the snapshot is of a corpus
+@return - true if the index held named documents when the snapshot was taken
+*/
+bool IndexSnapshot::isCorpus() const{
+    return documentCount > 0;
+}
+
+/*
+Calculates the id of a document from its name
+@param name - the name of the document
+@return - the id of the document, or -1 if no document has that name
+*/
+int IndexSnapshot::indexOfDocument(char* name) const{
+    for(int i = 0; i < documentCount; i++)
+        if(strcmp(documentNames[i], name) == 0) return i;
+    return -1;
+}
+
+/*
+Gets a view of a term and the pages it appeared on, split into one block per document
+@param id - the id of the term
+@return - the view, valid for as long as the snapshot is
+*/
+TermView IndexSnapshot::getView(int id) const{
+    const SnapshotTerm& term = header(id);
+    return TermView(term.term, term.pages, term.pageCount, term.skips, term.skipCount);
+}
+
+/*
+Writes a single term followed by a colon and a comma separated list of the pages it appeared on, all on one line,
+in the format described by TermView::write
+@param id - the id of the term to write
+@param out - the stream to which the term will be written
+*/
+void IndexSnapshot::writeTerm(int id, ostream& out) const{
+    getView(id).write(isCorpus()? documentNames: nullptr, out);
+}
+
+/*
+Writes a single term followed by a colon and a comma separated list of the pages it appeared on in one document
+@param id - the id of the term to write
+@param document - the id of the document
+@param out - the stream to which the term will be written
+*/
+void IndexSnapshot::writeTermInDocument(int id, int document, ostream& out) const{
+    getView(id).writeInDocument(document, out);
+}
+
+/*
+Writes every term that starts with a prefix, one per line in alphabetical order, in the format used by writeTerm
+@param prefix - the cstring every written term starts with. Case is ignored
+@param out - the stream to which the terms will be written
+@return - the number of terms written
+*/
+int IndexSnapshot::writePrefix(char* prefix, ostream& out) const{
+
+    //Find the matching terms in alphabetical order and write them out
+    int* ids = new int[termCount];
+    const IndexSnapshot* source = this;
+    int numMatches = findPrefix(prefix, termCount, [source](int id){ return source->getTerm(id); }, ids);
+    for(int i = 0; i < numMatches; i++)
+        writeTerm(ids[i], out);
+
+    delete[] ids;
+    return numMatches;
+}
+
+/*
+Destructor for IndexSnapshot, deletes the lists of chunks and document names. What they point to belongs to the SnapshotStore
+*/
+IndexSnapshot::~IndexSnapshot(){
+    delete[] chunks;
+    delete[] documentNames;
+}
@@ -0,0 +1,63 @@
+#ifndef INDEXSNAPSHOT_H
+#define INDEXSNAPSHOT_H
+
+#include <ostream>
+#include <atomic>
+
+#include "termview.h"
+
+//The number of terms whose headers are kept together, and copied together when any of them changes
+#define SNAPSHOT_CHUNK 16
+
+/*
+ * The SnapshotTerm struct is what a snapshot knows about one term. Its pages and skip list point into buffers that
+ * may be shared with newer snapshots, which see more of them. A snapshot only reads as far as its own counts
+ */
+struct SnapshotTerm
+{
+    char* term; //The lower case term
+    const int* pages; //Pages of the term, in increasing order within each document
+    int pageCount; //Number of pages the snapshot sees
+    const int* skips; //Skip list of the term, as (document, start of block in pages) pairs
+    int skipCount; //Number of skip list entries the snapshot sees, twice the number of blocks
+};
+
+/*
+ * The IndexSnapshot class is an immutable view of the terms and pages of an AutoIndex, taken at one moment.
+ * Term headers are held in chunks of SNAPSHOT_CHUNK, which point at the terms' pages and skip lists, and terms are found
+ * through a hash table. All of these are built by a SnapshotStore and shared with the snapshots before and after this one,
+ * so any number of threads can read a snapshot while the index it was taken from keeps growing.
+ * A snapshot only owns its own lists of chunks and document names
+ */
+class IndexSnapshot
+{
+private:
+    int termCount; //Number of terms in the snapshot
+    SnapshotTerm** chunks; //Term headers, SNAPSHOT_CHUNK per chunk. Term i is chunks[i / SNAPSHOT_CHUNK][i % SNAPSHOT_CHUNK]
+    const std::atomic<int>* slots; //Hash table from a term to its id, -1 for an empty slot. Ids of newer terms are skipped
+    int capacity; //Number of slots in the hash table, a power of two
+    int documentCount; //Number of documents in the corpus, 0 if the index isn't a corpus
+    char** documentNames; //Name of every document
+    const SnapshotTerm& header(int) const; //Gets the header of a term
+
+public:
+    IndexSnapshot(int, SnapshotTerm**, int, const std::atomic<int>*, int, char**, int); //Constructor, copies the lists of chunks and document names
+    IndexSnapshot(const IndexSnapshot&) = delete;
+    IndexSnapshot& operator=(const IndexSnapshot&) = delete;
+    ~IndexSnapshot(); //Destructor
+    IndexSnapshot* nextRetired; //Next snapshot in the index's list of snapshots waiting to be deleted
+    unsigned long retireEpoch; //Epoch in which the snapshot was replaced by a newer one
+    int indexOf(char*) const; //Gets the id of a word, or -1 if it isn't in the snapshot
+    int size() const; //Getter for the number of terms in the snapshot
+    char* getTerm(int) const; //Gets the term with the given id
+    const int* getPages(int) const; //Gets the pages on which a term appeared
+    int getPageCount(int) const; //Gets the number of pages on which a term appeared
+    bool isCorpus() const; //Whether the index was built from named documents
+    int indexOfDocument(char*) const; //Gets the id of a document from its name, or -1 if there is no such document
+    TermView getView(int) const; //Gets a view of a term and its blocks of pages
+    void writeTerm(int, std::ostream&) const; //Writes one term followed by the pages it appeared on
+    void writeTermInDocument(int, int, std::ostream&) const; //Writes one term followed by the pages it appeared on in one document
+    int writePrefix(char*, std::ostream&) const; //Writes every term starting with a prefix, in alphabetical order
+};
+
+#endif
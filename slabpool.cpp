@@ -0,0 +1,97 @@
+#include "slabpool.h"
+
+//Bytes reserved at the start of each slab for the pointer to the next slab
+#define SLAB_HEADER sizeof(char*)
+
+/*
+Default constructor for a SlabPool. No memory is taken from the heap until the first block is requested
+*/
+SlabPool::SlabPool()
+{
+    slabs = nullptr;
+    cursor = nullptr;
+    slabEnd = nullptr;
+
+    //Every size class starts with an empty free list
+    for(int i = 0; i < SLAB_SIZE_CLASSES; i++)
+        freeLists[i] = nullptr;
+}
+
+/*
+Gets the number of ints held by a block of a size class
+@param sizeClass - the size class being asked about
+@return - the capacity, in ints, of every block in that size class
+*/
+int SlabPool::capacityOf(int sizeClass){
+    return SLAB_BASE_BLOCK << sizeClass;
+}
+
+/*
+Allocates a new slab from the heap and links it into the list of slabs owned by the pool
+@param bytes - the number of usable bytes the slab must hold after its header
+@return - a pointer to the first usable byte in the new slab
+*/
+char* SlabPool::newSlab(long bytes){
+
+    //Allocate the slab and push it onto the front of the slab list
+    char* slab = new char[SLAB_HEADER + bytes];
+    *(char**)slab = slabs;
+    slabs = slab;
+
+    return slab + SLAB_HEADER;
+}
+
+/*
+Gets a block of memory from the pool, reusing a released block of the same size class when one is available
+@param sizeClass - the size class of the requested block
+@return - a block with room for capacityOf(sizeClass) ints. The contents are garbage
+*/
+int* SlabPool::allocate(int sizeClass){
+
+    //Reuse the most recently released block of this size, if there is one
+    if(freeLists[sizeClass] != nullptr){
+        void* block = freeLists[sizeClass];
+        freeLists[sizeClass] = *(void**)block;
+        return (int*)block;
+    }
+
+    long bytes = (long)capacityOf(sizeClass) * sizeof(int);
+
+    //Blocks too large to share a slab get a slab to themselves, leaving the current slab untouched
+    if(bytes > SLAB_BYTES - (long)SLAB_HEADER)
+        return (int*)newSlab(bytes);
+
+    //Start a new slab if the rest of the current one can't hold this block
+    if(cursor == nullptr || slabEnd - cursor < bytes){
+        cursor = newSlab(SLAB_BYTES - SLAB_HEADER);
+        slabEnd = cursor + SLAB_BYTES - SLAB_HEADER;
+    }
+
+    //Bump the cursor past the new block
+    int* block = (int*)cursor;
+    cursor += bytes;
+    return block;
+}
+
+/*
+Returns a block to the free list of its size class so that a later allocation can reuse it
+@param block - the block being released
+@param sizeClass - the size class the block was allocated with
+*/
+void SlabPool::release(int* block, int sizeClass){
+    *(void**)block = freeLists[sizeClass];
+    freeLists[sizeClass] = block;
+}
+
+/*
+Destructor for SlabPool, frees every slab (and therefore every block) at once
+*/
+SlabPool::~SlabPool(){
+
+    //Walk the slab list, deleting each slab after reading the pointer to the next one
+    while(slabs != nullptr){
+        char* next = *(char**)slabs;
+        delete[] slabs;
+        slabs = next;
+    }
+}
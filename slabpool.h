@@ -0,0 +1,35 @@
+#ifndef SLABPOOL_H
+#define SLABPOOL_H
+
+//The number of ints in a block of the smallest size class. Each larger size class doubles the one below it
+#define SLAB_BASE_BLOCK 10
+//The number of size classes available. The largest block holds SLAB_BASE_BLOCK << (SLAB_SIZE_CLASSES - 1) ints
+#define SLAB_SIZE_CLASSES 28
+//The number of bytes carved out of the heap at once for small blocks
+#define SLAB_BYTES 65536
+
+/*
+ * The SlabPool class hands out int blocks from large slabs grouped into power of two size classes.
+ * Released blocks are kept on a free list for their size class and reused, and every slab is
+ * returned to the heap at once when the pool is destroyed.
+ */
+class SlabPool
+{
+private:
+    char* slabs; //Linked list of every slab owned by the pool. The first bytes of each slab point to the next one
+    char* cursor; //Next unused byte in the current slab
+    char* slabEnd; //One past the last byte of the current slab
+    void* freeLists[SLAB_SIZE_CLASSES]; //Heads of the free lists. A released block stores the next free block in its first bytes
+    char* newSlab(long); //Allocates a slab with room for the requested number of bytes and links it into the slab list
+
+public:
+    SlabPool(); //Default constructor
+    SlabPool(const SlabPool&) = delete; //Blocks cannot be shared between pools
+    SlabPool& operator=(const SlabPool&) = delete;
+    ~SlabPool(); //Destructor, frees every slab
+    int* allocate(int); //Gets a block of the given size class
+    void release(int*, int); //Returns a block of the given size class to the pool for reuse
+    static int capacityOf(int); //Number of ints held by a block of the given size class
+};
+
+#endif
@@ -0,0 +1,38 @@
+#include "snapshotreader.h"
+
+/*
+Constructor for a SnapshotReader. Claims a reader slot from the index, waiting for one if they are all taken
+@param source - the index whose snapshots will be read
+*/
+SnapshotReader::SnapshotReader(AutoIndex& source)
+{
+    index = &source;
+    slot = index->claimReaderSlot();
+    current = nullptr;
+}
+
+/*
+Gets the latest snapshot of the index. It stays valid until release or acquire is called again or the reader is destroyed
+@return - the latest snapshot, or nullptr if the index hasn't published one yet
+*/
+const IndexSnapshot* SnapshotReader::acquire(){
+    release();
+    current = index->acquireSnapshot(slot);
+    return current;
+}
+
+/*
+Releases the snapshot being held, so that it can be deleted once it has been replaced
+*/
+void SnapshotReader::release(){
+    index->releaseSnapshot(slot);
+    current = nullptr;
+}
+
+/*
+Destructor for SnapshotReader, releases the snapshot being held and gives the reader slot back
+*/
+SnapshotReader::~SnapshotReader(){
+    release();
+    index->releaseReaderSlot(slot);
+}
@@ -0,0 +1,27 @@
+#ifndef SNAPSHOTREADER_H
+#define SNAPSHOTREADER_H
+
+#include "autoindex.h"
+#include "indexsnapshot.h"
+
+/*
+ * The SnapshotReader class lets a thread read the snapshots of an AutoIndex while another thread keeps adding to it.
+ * It holds one of the index's reader slots for as long as it exists
+ */
+class SnapshotReader
+{
+private:
+    AutoIndex* index; //The index whose snapshots are read
+    int slot; //The reader slot claimed from the index
+    const IndexSnapshot* current; //The snapshot acquired, or nullptr if none is held
+
+public:
+    SnapshotReader(AutoIndex&); //Constructor, claims a reader slot
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+    ~SnapshotReader(); //Destructor, releases the snapshot and the reader slot
+    const IndexSnapshot* acquire(); //Gets the latest snapshot, releasing the one held before
+    void release(); //Releases the snapshot being held
+};
+
+#endif
@@ -0,0 +1,373 @@
+#include "snapshotstore.h"
+#include "dictionary.h"
+
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+
+/*
+Default constructor for a SnapshotStore, which starts with no terms and an empty hash table
+*/
+SnapshotStore::SnapshotStore()
+{
+    termCount = 0;
+    terms = nullptr;
+    termCapacity = 0;
+    termBlocks = nullptr;
+    chunks = nullptr;
+    chunkChanged = nullptr;
+    changedChunks = nullptr;
+    numChanged = 0;
+    chunkCount = 0;
+    chunkCapacity = 0;
+    documentNames = nullptr;
+    documentCount = 0;
+    documentCapacity = 0;
+    retiredBlocks = nullptr;
+    numRetired = 0;
+    retiredCapacity = 0;
+    numPending = 0;
+
+    //Start with an empty table
+    capacity = DICTIONARY_START_CAPACITY;
+    slots = new atomic<int>[capacity];
+    for(int i = 0; i < capacity; i++)
+        slots[i].store(-1, memory_order_relaxed);
+}
+
+/*
+Makes room for the writer's side of at least a number of terms, doubling the array as needed
+@param needed - the number of terms to make room for
+*/
+void SnapshotStore::growTerms(int needed){
+    if(needed <= termCapacity) return;
+    int newCapacity = (termCapacity == 0)? SNAPSHOT_CHUNK: termCapacity;
+    while(newCapacity < needed) newCapacity *= 2;
+
+    StoreTerm* temp = new StoreTerm[newCapacity];
+    for(int i = 0; i < termCount; i++)
+        temp[i] = terms[i];
+    delete[] terms;
+    terms = temp;
+    termCapacity = newCapacity;
+}
+
+/*
+Makes room for at least a number of chunks, doubling the arrays as needed
+@param needed - the number of chunks to make room for
+*/
+void SnapshotStore::growChunks(int needed){
+    if(needed <= chunkCapacity) return;
+    int newCapacity = (chunkCapacity == 0)? RESIZE_FACTOR: chunkCapacity;
+    while(newCapacity < needed) newCapacity *= 2;
+
+    char** blocksTemp = new char*[newCapacity];
+    SnapshotTerm** chunksTemp = new SnapshotTerm*[newCapacity];
+    bool* changedTemp = new bool[newCapacity];
+    int* listTemp = new int[newCapacity];
+    for(int i = 0; i < chunkCount; i++){
+        blocksTemp[i] = termBlocks[i];
+        chunksTemp[i] = chunks[i];
+        changedTemp[i] = chunkChanged[i];
+    }
+    for(int i = 0; i < numChanged; i++)
+        listTemp[i] = changedChunks[i];
+
+    delete[] termBlocks;
+    delete[] chunks;
+    delete[] chunkChanged;
+    delete[] changedChunks;
+    termBlocks = blocksTemp;
+    chunks = chunksTemp;
+    chunkChanged = changedTemp;
+    changedChunks = listTemp;
+    chunkCapacity = newCapacity;
+}
+
+/*
+Moves every term into a new hash table with more slots. The old table is kept until no reader can be using it
+@param newCapacity - the number of slots in the new table, a power of two
+*/
+void SnapshotStore::growTable(int newCapacity){
+    atomic<int>* oldSlots = slots;
+    slots = new atomic<int>[newCapacity];
+    capacity = newCapacity;
+    for(int i = 0; i < capacity; i++)
+        slots[i].store(-1, memory_order_relaxed);
+
+    //Rehash the terms of the latest snapshot. The new table isn't seen by readers until the next snapshot is published
+    for(int id = 0; id < termCount; id++)
+        insertTerm(id);
+    retire(nullptr, 0, nullptr, oldSlots);
+}
+
+/*
+Adds a term to the hash table. Readers of older snapshots may be probing the table at the same time,
+which is why slots are only ever filled, never moved or emptied
+@param id - the id of the term, whose text must already be in its term block
+*/
+void SnapshotStore::insertTerm(int id){
+    char* term = termBlocks[id / SNAPSHOT_CHUNK] + 41 * (id % SNAPSHOT_CHUNK);
+    int slot = Dictionary::hash(term) & (capacity - 1);
+    while(slots[slot].load(memory_order_relaxed) != -1) slot = (slot + 1) & (capacity - 1);
+    slots[slot].store(id, memory_order_relaxed);
+}
+
+/*
+Marks a chunk as holding a term that changed, so the next snapshot gets an updated copy of it
+@param chunk - the chunk to mark
+*/
+void SnapshotStore::changeChunk(int chunk){
+    if(chunkChanged[chunk]) return;
+    chunkChanged[chunk] = true;
+    changedChunks[numChanged++] = chunk;
+}
+
+/*
+Records that a term of the latest snapshot got a new page. New terms don't need to be recorded, since every one of them changes
+@param id - the id of the term
+@param beforeLast - true if the page may have gone somewhere other than the end of the term's pages
+*/
+void SnapshotStore::touch(int id, bool beforeLast){
+    if(id >= termCount) return;
+    changeChunk(id / SNAPSHOT_CHUNK);
+    if(beforeLast) terms[id].rewritten = true;
+}
+
+/*
+Gets the number of pointers every snapshot copies no matter how few terms changed, which is the least worth waiting for between snapshots
+@return - the number of chunks and document names in the latest snapshot
+*/
+int SnapshotStore::publishCost() const{
+    return chunkCount + documentCount;
+}
+
+/*
+Adds a block that the latest snapshot stopped using to the retired list. It stays pending until the snapshot
+that was still using it is replaced, and is deleted once no reader can be using that snapshot
+@param ints - a replaced page or skip list buffer, or nullptr
+@param sizeClass - the size class of ints in the pool
+@param chunk - a replaced chunk of term headers, or nullptr
+@param table - a replaced hash table, or nullptr
+*/
+void SnapshotStore::retire(int* ints, int sizeClass, SnapshotTerm* chunk, atomic<int>* table){
+    if(numRetired == retiredCapacity){
+        int newCapacity = (retiredCapacity == 0)? RESIZE_FACTOR: retiredCapacity * 2;
+        RetiredBlock* temp = new RetiredBlock[newCapacity];
+        for(int i = 0; i < numRetired; i++)
+            temp[i] = retiredBlocks[i];
+        delete[] retiredBlocks;
+        retiredBlocks = temp;
+        retiredCapacity = newCapacity;
+    }
+
+    retiredBlocks[numRetired].ints = ints;
+    retiredBlocks[numRetired].sizeClass = sizeClass;
+    retiredBlocks[numRetired].chunk = chunk;
+    retiredBlocks[numRetired].slots = table;
+    retiredBlocks[numRetired].epoch = 0;
+    numRetired++;
+    numPending++;
+}
+
+/*
+Brings a buffer up to date with a list, copying only the ints past the ones already in it. If the list no longer
+starts with those ints, or there is no room for the new ones, the whole list is copied into a new buffer from the
+smallest size class that fits twice as many ints, and the old buffer is retired, since older snapshots may still be reading it
+@param buffer - the buffer, or nullptr if there is none yet
+@param sizeClass - the size class of the buffer, or -1 if there is none. Updated if a new buffer is made
+@param copied - the number of ints of the list already in the buffer
+@param count - the number of ints in the list
+@param list - the list to copy from
+@param rewrite - true if the ints already copied may have changed
+@return - the buffer holding the whole list
+*/
+int* SnapshotStore::extend(int* buffer, int& sizeClass, int copied, int count, const int* list, bool rewrite){
+    if(rewrite || buffer == nullptr || count > SlabPool::capacityOf(sizeClass)){
+        int newClass = 0;
+        while(SlabPool::capacityOf(newClass) < count * 2) newClass++;
+        int* temp = pool.allocate(newClass);
+        memcpy(temp, list, count * sizeof(int));
+        if(buffer != nullptr) retire(buffer, sizeClass, nullptr, nullptr);
+        sizeClass = newClass;
+        return temp;
+    }
+
+    //Older snapshots only read the ints they were published with, so the ones past them can be written in place
+    memcpy(buffer + copied, list + copied, (count - copied) * sizeof(int));
+    return buffer;
+}
+
+/*
+Replaces a chunk of term headers with an updated copy, bringing the buffers of every one of its terms up to date
+@param chunk - the chunk to update
+@param numbers - the page lists of the index
+@param documentBlocks - the skip lists of the index
+*/
+void SnapshotStore::updateChunk(int chunk, ArrayList2D& numbers, ArrayList2D& documentBlocks){
+
+    //Start from the chunk's headers in the latest snapshot, which must not change under its readers.
+    //A new chunk starts with empty headers, so that every term in it is copied in full
+    SnapshotTerm* fresh = new SnapshotTerm[SNAPSHOT_CHUNK];
+    if(chunks[chunk] != nullptr){
+        memcpy(fresh, chunks[chunk], SNAPSHOT_CHUNK * sizeof(SnapshotTerm));
+        retire(nullptr, 0, chunks[chunk], nullptr);
+    } else {
+        for(int i = 0; i < SNAPSHOT_CHUNK; i++){
+            fresh[i].term = termBlocks[chunk] + 41 * i;
+            fresh[i].pages = nullptr;
+            fresh[i].pageCount = 0;
+            fresh[i].skips = nullptr;
+            fresh[i].skipCount = 0;
+        }
+    }
+    chunks[chunk] = fresh;
+    chunkChanged[chunk] = false;
+
+    //Copy whatever was added to each term since the latest snapshot
+    int first = chunk * SNAPSHOT_CHUNK;
+    int last = min(first + SNAPSHOT_CHUNK, termCount);
+    for(int id = first; id < last; id++){
+        SnapshotTerm& header = fresh[id - first];
+        StoreTerm& term = terms[id];
+        int pageCount = numbers.getSizeOfSublist(id);
+        int skipCount = documentBlocks.getSizeOfSublist(id);
+        if(pageCount == header.pageCount && skipCount == header.skipCount && !term.rewritten) continue;
+
+        term.pages = extend(term.pages, term.pageClass, header.pageCount, pageCount, numbers.getSublist(id), term.rewritten);
+        term.skips = extend(term.skips, term.skipClass, header.skipCount, skipCount, documentBlocks.getSublist(id), false);
+        term.rewritten = false;
+        header.pages = term.pages;
+        header.pageCount = pageCount;
+        header.skips = term.skips;
+        header.skipCount = skipCount;
+    }
+}
+
+/*
+Builds a snapshot of the index, sharing everything that didn't change since the latest snapshot.
+The cost is the number of chunks and documents, plus the headers of the changed chunks and the pages added to them
+@param words - the words of the index
+@param numbers - the page lists of the index, parallel to words
+@param documentBlocks - the skip lists of the index, parallel to words
+@param documents - the names of the documents in the corpus
+@param numDocuments - the number of names in documents
+@return - the new snapshot, which the caller publishes
+*/
+IndexSnapshot* SnapshotStore::build(const ArrayList& words, ArrayList2D& numbers, ArrayList2D& documentBlocks, char** documents, int numDocuments){
+
+    //Make room for the new terms and their chunks
+    int newCount = words.size();
+    int newChunkCount = (newCount + SNAPSHOT_CHUNK - 1) / SNAPSHOT_CHUNK;
+    growTerms(newCount);
+    growChunks(newChunkCount);
+    for(int c = chunkCount; c < newChunkCount; c++){
+        termBlocks[c] = new char[SNAPSHOT_CHUNK * 41];
+        chunks[c] = nullptr;
+        chunkChanged[c] = false;
+    }
+
+    //Copy the text of each new term into its chunk and give it empty buffers
+    for(int id = termCount; id < newCount; id++){
+        memcpy(termBlocks[id / SNAPSHOT_CHUNK] + 41 * (id % SNAPSHOT_CHUNK), words.get(id), 41);
+        terms[id].pages = nullptr;
+        terms[id].pageClass = -1;
+        terms[id].skips = nullptr;
+        terms[id].skipClass = -1;
+        terms[id].rewritten = false;
+        changeChunk(id / SNAPSHOT_CHUNK);
+    }
+
+    int oldCount = termCount;
+    termCount = newCount;
+    chunkCount = newChunkCount;
+
+    //Keep the hash table under half full, then add the new terms to it
+    if(termCount * 2 > capacity){
+        int newCapacity = capacity;
+        while(termCount * 2 > newCapacity) newCapacity *= 2;
+        growTable(newCapacity);
+    } else {
+        for(int id = oldCount; id < termCount; id++)
+            insertTerm(id);
+    }
+
+    //Copy the chunks holding a term that changed
+    for(int i = 0; i < numChanged; i++)
+        updateChunk(changedChunks[i], numbers, documentBlocks);
+    numChanged = 0;
+
+    //Copy the names of the new documents
+    if(numDocuments > documentCapacity){
+        int newCapacity = (documentCapacity == 0)? RESIZE_FACTOR: documentCapacity;
+        while(newCapacity < numDocuments) newCapacity *= 2;
+        char** temp = new char*[newCapacity];
+        for(int i = 0; i < documentCount; i++)
+            temp[i] = documentNames[i];
+        delete[] documentNames;
+        documentNames = temp;
+        documentCapacity = newCapacity;
+    }
+    for(int i = documentCount; i < numDocuments; i++){
+        documentNames[i] = new char[strlen(documents[i]) + 1];
+        strcpy(documentNames[i], documents[i]);
+    }
+    documentCount = numDocuments;
+
+    return new IndexSnapshot(termCount, chunks, chunkCount, slots, capacity, documentNames, documentCount);
+}
+
+/*
+Records the epoch in which the snapshot that was still using the pending retired blocks was replaced
+@param epoch - the epoch the replaced snapshot was retired in
+*/
+void SnapshotStore::retirePending(unsigned long epoch){
+    for(int i = numRetired - numPending; i < numRetired; i++)
+        retiredBlocks[i].epoch = epoch;
+    numPending = 0;
+}
+
+/*
+Deletes every retired block whose last snapshot was replaced before the earliest epoch any reader is reading in.
+Blocks are retired in order, so these are always at the front of the list
+@param oldest - the earliest epoch any reader is reading in
+*/
+void SnapshotStore::reclaim(unsigned long oldest){
+    int done = 0;
+    while(done < numRetired - numPending && retiredBlocks[done].epoch < oldest){
+        if(retiredBlocks[done].ints != nullptr) pool.release(retiredBlocks[done].ints, retiredBlocks[done].sizeClass);
+        delete[] retiredBlocks[done].chunk;
+        delete[] retiredBlocks[done].slots;
+        done++;
+    }
+
+    //Move the blocks that are left to the front
+    for(int i = done; i < numRetired; i++)
+        retiredBlocks[i - done] = retiredBlocks[i];
+    numRetired -= done;
+}
+
+/*
+Destructor for SnapshotStore, deletes every chunk, table and name, along with every retired block. The buffers go with the pool
+*/
+SnapshotStore::~SnapshotStore(){
+    for(int c = 0; c < chunkCount; c++){
+        delete[] termBlocks[c];
+        delete[] chunks[c];
+    }
+    for(int i = 0; i < documentCount; i++)
+        delete[] documentNames[i];
+    for(int i = 0; i < numRetired; i++){
+        delete[] retiredBlocks[i].chunk;
+        delete[] retiredBlocks[i].slots;
+    }
+    delete[] terms;
+    delete[] termBlocks;
+    delete[] chunks;
+    delete[] chunkChanged;
+    delete[] changedChunks;
+    delete[] slots;
+    delete[] documentNames;
+    delete[] retiredBlocks;
+}
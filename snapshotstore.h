@@ -0,0 +1,89 @@
+#ifndef SNAPSHOTSTORE_H
+#define SNAPSHOTSTORE_H
+
+#include <atomic>
+
+#include "ArrayList.h"
+#include "arraylist2d.h"
+#include "indexsnapshot.h"
+#include "slabpool.h"
+
+/*
+ * The StoreTerm struct is the writer's side of one term: the buffers its pages and skip list are copied into
+ */
+struct StoreTerm
+{
+    int* pages; //Pages of the term as of the latest snapshot, with room to append more
+    int pageClass; //Size class of pages in the store's pool, or -1 if there is no buffer yet
+    int* skips; //Skip list of the term as of the latest snapshot, with room to append more
+    int skipClass; //Size class of skips in the store's pool, or -1 if there is no buffer yet
+    bool rewritten; //Set when a page was inserted before the last one, so the pages already shared have changed
+};
+
+/*
+ * The RetiredBlock struct is a block that the latest snapshot stopped using but older snapshots may still be reading.
+ * Exactly one of its pointers is set
+ */
+struct RetiredBlock
+{
+    int* ints; //A page or skip list buffer that was replaced by a bigger one
+    int sizeClass; //Size class of ints in the store's pool
+    SnapshotTerm* chunk; //A chunk of term headers that was replaced by an updated copy
+    std::atomic<int>* slots; //A hash table that was replaced by a bigger one
+    unsigned long epoch; //Epoch in which the last snapshot using the block was replaced, or 0 until that happens
+};
+
+/*
+ * The SnapshotStore class builds the snapshots of an AutoIndex so that consecutive snapshots share everything that didn't change.
+ * A term's pages and skip list are copied once into buffers from a SlabPool that only ever grow at the end. A newer snapshot sees more of a
+ * buffer than an older one, but never changes the part the older one sees. Term headers are kept in chunks of SNAPSHOT_CHUNK
+ * terms, and a new snapshot copies only the chunks holding a term that changed since the last one. The hash table is
+ * shared too: new terms are added to free slots, which readers of older snapshots skip because their ids are too high.
+ * Buffers, chunks and tables that were replaced are kept until no reader can still be using a snapshot that pointed to them.
+ * Only the thread adding to the index may use the store
+ */
+class SnapshotStore
+{
+private:
+    SlabPool pool; //Allocator for the page and skip list buffers
+    int termCount; //Number of terms in the latest snapshot
+    StoreTerm* terms; //Writer's side of every term in the latest snapshot
+    int termCapacity; //Number of entries in terms
+    char** termBlocks; //Text of the terms of each chunk, SNAPSHOT_CHUNK * 41 chars apiece. Never moved once allocated
+    SnapshotTerm** chunks; //Term headers of each chunk as of the latest snapshot
+    bool* chunkChanged; //Whether each chunk holds a term that changed since the latest snapshot
+    int* changedChunks; //The chunks marked in chunkChanged
+    int numChanged; //Number of chunks in changedChunks
+    int chunkCount; //Number of chunks in the latest snapshot
+    int chunkCapacity; //Number of entries in termBlocks, chunks and chunkChanged, and of ints in changedChunks
+    std::atomic<int>* slots; //Hash table from a term to its id, -1 for an empty slot
+    int capacity; //Number of slots in the hash table, a power of two
+    char** documentNames; //Copy of the name of every document in the latest snapshot
+    int documentCount; //Number of documents in the latest snapshot
+    int documentCapacity; //Number of pointers in documentNames
+    RetiredBlock* retiredBlocks; //Replaced blocks, oldest first
+    int numRetired; //Number of blocks in retiredBlocks
+    int retiredCapacity; //Number of entries in retiredBlocks
+    int numPending; //Number of blocks at the end of retiredBlocks still used by the published snapshot
+    void growTerms(int); //Makes room for the writer's side of a number of terms
+    void growChunks(int); //Makes room for a number of chunks
+    void growTable(int); //Moves every term into a bigger hash table
+    void insertTerm(int); //Adds a term to the hash table
+    void changeChunk(int); //Marks a chunk as needing a new copy in the next snapshot
+    void retire(int*, int, SnapshotTerm*, std::atomic<int>*); //Keeps a replaced block until no reader can be using it
+    int* extend(int*, int&, int, int, const int*, bool); //Copies new ints into a buffer, moving to a bigger one if needed
+    void updateChunk(int, ArrayList2D&, ArrayList2D&); //Copies a changed chunk of headers, bringing its terms up to date
+
+public:
+    SnapshotStore(); //Default constructor
+    SnapshotStore(const SnapshotStore&) = delete;
+    SnapshotStore& operator=(const SnapshotStore&) = delete;
+    ~SnapshotStore(); //Destructor, deletes every block. No reader may be using a snapshot built by the store
+    void touch(int, bool); //Records that a term got a new page, and whether the page went before its last one
+    int publishCost() const; //Number of pointers every snapshot copies no matter how little changed
+    IndexSnapshot* build(const ArrayList&, ArrayList2D&, ArrayList2D&, char**, int); //Builds a snapshot of the index
+    void retirePending(unsigned long); //Records the epoch in which the snapshot using the latest replaced blocks was replaced
+    void reclaim(unsigned long); //Deletes the replaced blocks that no reader can still be using
+};
+
+#endif
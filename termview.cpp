@@ -0,0 +1,147 @@
+#include "termview.h"
+
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+
+using namespace std;
+
+int strCompare(char*, char*); //Compare the alphabetical order of two cstrings
+
+/*
+Constructor for a TermView. Nothing is copied
+@param word - the lower case term
+@param termPages - the pages of the term, in increasing order within each document
+@param numPages - the number of pages
+@param termSkips - the skip list of the term, as (document, start of block in termPages) pairs
+@param numSkips - the number of ints in the skip list
+*/
+TermView::TermView(char* word, const int* termPages, int numPages, const int* termSkips, int numSkips)
+{
+    term = word;
+    pages = termPages;
+    pageCount = numPages;
+    skips = termSkips;
+    skipCount = numSkips;
+}
+
+/*
+Gets the number of documents in which the term appeared, which is the number of blocks its pages are split into.
+A term of an index that isn't a corpus has one block
+@return - the number of blocks of pages
+*/
+int TermView::getBlockCount() const{
+    return skipCount / 2;
+}
+
+/*
+Gets the document that one of the term's blocks of pages belongs to. Blocks are in increasing order of document
+@param block - the index of the block
+@return - the id of the document
+*/
+int TermView::getBlockDocument(int block) const{
+    return skips[2*block];
+}
+
+/*
+Gets one of the term's blocks of pages, without copying it
+@param block - the index of the block
+@param count - set to the number of pages in the block
+@return - a pointer to the pages of the block in increasing order
+*/
+const int* TermView::getBlockPages(int block, int& count) const{
+
+    //A block runs from its own start to the start of the next block, or to the end of the pages for the last block
+    int start = skips[2*block + 1];
+    int end = (block + 1 < getBlockCount())? skips[2*block + 3]: pageCount;
+    count = end - start;
+    return pages + start;
+}
+
+/*
+Finds the block of the term's pages that belongs to one document, using a binary search of the skip list
+so that the blocks of other documents are never read
+@param document - the id of the document
+@return - the index of the block, or -1 if the term doesn't appear in that document
+*/
+int TermView::findBlock(int document) const{
+    int low = 0;
+    int high = getBlockCount() - 1;
+    while(low <= high){
+        int middle = (low + high) / 2;
+        int middleDocument = getBlockDocument(middle);
+        if(middleDocument == document) return middle;
+        if(middleDocument < document){
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return -1;
+}
+
+/*
+Writes the term followed by a colon and a comma separated list of the pages it appeared on, all on one line.
+In a corpus, the pages are grouped by document as "name: 1, 2; name: 3"
+@param documentNames - the names of the documents of the corpus, or nullptr if the index isn't a corpus
+@param out - the stream to which the term will be written
+*/
+void TermView::write(char** documentNames, ostream& out) const{
+    out << term << ": ";
+    for(int b = 0; b < getBlockCount(); b++){
+        int count;
+        const int* blockPages = getBlockPages(b, count);
+        if(documentNames != nullptr) out << ((b == 0)? "": "; ") << documentNames[getBlockDocument(b)] << ": ";
+        for(int k = 0; k < count; k++)
+            out << ((k == 0)? "": ", ") << blockPages[k];
+    }
+    out << endl;
+}
+
+/*
+Writes the term followed by a colon and a comma separated list of the pages it appeared on in one document
+@param document - the id of the document
+@param out - the stream to which the term will be written
+*/
+void TermView::writeInDocument(int document, ostream& out) const{
+    out << term << ": ";
+    int block = findBlock(document);
+    if(block != -1){
+        int count;
+        const int* blockPages = getBlockPages(block, count);
+        for(int k = 0; k < count; k++)
+            out << ((k == 0)? "": ", ") << blockPages[k];
+    }
+    out << endl;
+}
+
+/*
+Helper method - collects the ids of every term that starts with a prefix, sorted alphabetically by their terms
+@param prefix - the cstring every collected term starts with. Case is ignored, as is anything past 40 characters
+@param termCount - the number of terms, whose ids run from 0 to termCount-1
+@param getTerm - gets the lower case term with an id
+@param ids - set to the ids of the matching terms. Must have room for termCount ids
+@return - the number of matching terms
+*/
+int findPrefix(char* prefix, int termCount, const function<char*(int)>& getTerm, int* ids){
+
+    //Move the prefix to lower case so it can be compared against the saved terms
+    char key[41] = {0};
+    int keyLength = 0;
+    while(keyLength < 40 && prefix[keyLength] != '\0'){
+        key[keyLength] = tolower((unsigned char)prefix[keyLength]);
+        keyLength++;
+    }
+
+    //Collect the ids of the matching terms
+    int numMatches = 0;
+    for(int i = 0; i < termCount; i++)
+        if(strncmp(getTerm(i), key, keyLength) == 0)
+            ids[numMatches++] = i;
+
+    //Sort the ids by the terms they stand for
+    std::sort(ids, ids + numMatches, [&getTerm](int a, int b){
+        return strCompare(getTerm(a), getTerm(b)) < 0;
+    });
+    return numMatches;
+}
@@ -0,0 +1,35 @@
+#ifndef TERMVIEW_H
+#define TERMVIEW_H
+
+#include <ostream>
+#include <functional>
+
+/*
+ * The TermView class is a read only view of one term and the pages it appeared on. The pages are split into one block
+ * per document, in increasing order of document, with a skip list of (document, start of block) pairs over them.
+ * AutoIndex and IndexSnapshot keep their pages in different places, but both hand out TermViews,
+ * so that finding a document's block and writing a term for a lookup work the same for both.
+ * A view is only valid for as long as the pages it was taken from are
+ */
+class TermView
+{
+private:
+    char* term; //The lower case term
+    const int* pages; //Pages of the term, in increasing order within each document
+    int pageCount; //Number of pages
+    const int* skips; //Skip list of the term, as (document, start of block in pages) pairs
+    int skipCount; //Number of ints in the skip list, twice the number of blocks
+
+public:
+    TermView(char*, const int*, int, const int*, int); //Constructor, takes the term, its pages and its skip list
+    int getBlockCount() const; //Gets the number of documents in which the term appeared
+    int getBlockDocument(int) const; //Gets the document of one of the term's blocks of pages
+    const int* getBlockPages(int, int&) const; //Gets one of the term's blocks of pages
+    int findBlock(int) const; //Finds the block of the term's pages that belongs to a document
+    void write(char**, std::ostream&) const; //Writes the term followed by the pages it appeared on
+    void writeInDocument(int, std::ostream&) const; //Writes the term followed by the pages it appeared on in one document
+};
+
+int findPrefix(char*, int, const std::function<char*(int)>&, int*); //Collects the ids of the terms starting with a prefix, in alphabetical order
+
+#endif
@@ -0,0 +1,175 @@
+#include "tokenizer.h"
+
+#include <climits>
+
+//States of the tokenizer, saying what the characters being read belong to
+#define STATE_BETWEEN 0 //Whitespace between tokens
+#define STATE_WORD 1 //A plain word
+#define STATE_PHRASE 2 //A word inside a [multi word phrase]
+#define STATE_PHRASE_GAP 3 //Whitespace inside a [multi word phrase], which becomes a single space if more words follow
+#define STATE_PAGE_START 4 //The character right after the '<' of a page marker, which is '-' for the end marker
+#define STATE_PAGE 5 //The digits of a <n> page marker
+#define STATE_SKIP 6 //The rest of a token after its closing ']' or '>', which is ignored
+
+/*
+Helper method - checks for the whitespace characters that separate tokens, the same ones the >> operator skips
+@param c - the character to check
+@return - true if c is whitespace
+*/
+static bool isSeparator(char c){
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/*
+Default constructor for a Tokenizer, which starts between tokens
+*/
+Tokenizer::Tokenizer()
+{
+    state = STATE_BETWEEN;
+    length = 0;
+    page = 0;
+    pageDigitsDone = false;
+    token[0] = '\0';
+}
+
+/*
+Ends the word or phrase being built by null terminating it
+@return - TOKEN_WORD, or TOKEN_NONE if nothing was built (as in "[]")
+*/
+int Tokenizer::finishToken(){
+    token[length] = '\0';
+    return (length > 0)? TOKEN_WORD: TOKEN_NONE;
+}
+
+/*
+Reads characters from a buffer until a token is completed or the buffer runs out. Whatever token is
+being read when the buffer runs out is kept, and the next call carries on with it from the next buffer
+@param cursor - the next character to read. Moved past every character that was read
+@param end - one past the last character of the buffer
+@return - the type of the completed token (TOKEN_WORD, TOKEN_PAGE or TOKEN_END), or TOKEN_NONE if the buffer ran out first
+*/
+int Tokenizer::next(const char*& cursor, const char* end){
+
+    while(cursor < end){
+        char c = *cursor;
+        cursor++;
+
+        switch(state){
+
+        case STATE_BETWEEN:
+            //The first character of a token decides what kind of token it is
+            if(isSeparator(c)) break;
+            length = 0;
+            if(c == '['){
+                state = STATE_PHRASE;
+            } else if(c == '<'){
+                state = STATE_PAGE_START;
+                page = 0;
+                pageDigitsDone = false;
+            } else {
+                state = STATE_WORD;
+                token[length++] = c;
+            }
+            break;
+
+        case STATE_WORD:
+            //A word ends at the next whitespace. Characters past the maximum length are dropped
+            if(isSeparator(c)){
+                state = STATE_BETWEEN;
+                return finishToken();
+            }
+            if(length < TOKEN_MAX_LENGTH) token[length++] = c;
+            break;
+
+        case STATE_PHRASE_GAP:
+            //Whitespace inside a phrase is collapsed into the single space put in front of the next word
+            if(isSeparator(c)) break;
+            if(c != ']'){
+                if(length > 0 && length < TOKEN_MAX_LENGTH) token[length++] = ' ';
+                state = STATE_PHRASE;
+            }
+            //fall through
+
+        case STATE_PHRASE:
+            //A phrase ends at the closing bracket, and the rest of the token holding the bracket is skipped
+            if(c == ']'){
+                state = STATE_SKIP;
+                if(finishToken() == TOKEN_WORD) return TOKEN_WORD;
+            } else if(isSeparator(c)){
+                state = STATE_PHRASE_GAP;
+            } else if(length < TOKEN_MAX_LENGTH){
+                token[length++] = c;
+            }
+            break;
+
+        case STATE_PAGE_START:
+            //A '-' right after the '<' marks the end of the input. Whatever follows it in the buffer is left unread,
+            //so the tokenizer goes back to waiting for a token, ready for the next input
+            if(c == '-'){
+                state = STATE_BETWEEN;
+                return TOKEN_END;
+            }
+            state = STATE_PAGE;
+            //fall through
+
+        case STATE_PAGE:
+            //The page number ends at the '>' or the next whitespace, and is built digit by digit as it is read
+            if(isSeparator(c)){
+                state = STATE_BETWEEN;
+                return TOKEN_PAGE;
+            }
+            if(c == '>'){
+                state = STATE_SKIP;
+                return TOKEN_PAGE;
+            }
+            //A page number too big for an int is clamped to INT_MAX, and any digits after that are ignored
+            if(!pageDigitsDone && c >= '0' && c <= '9'){
+                if(page > (INT_MAX - (c - '0')) / 10){
+                    page = INT_MAX;
+                    pageDigitsDone = true;
+                } else {
+                    page = page * 10 + (c - '0');
+                }
+            } else {
+                pageDigitsDone = true;
+            }
+            break;
+
+        case STATE_SKIP:
+            if(isSeparator(c)) state = STATE_BETWEEN;
+            break;
+        }
+    }
+
+    //The buffer ran out in the middle of (or before) the next token
+    return TOKEN_NONE;
+}
+
+/*
+Completes the token left unfinished at the end of the input. A phrase missing its closing bracket is taken as it stands
+@return - the type of the completed token, or TOKEN_NONE if the input ended between tokens
+*/
+int Tokenizer::finish(){
+    int type = TOKEN_NONE;
+    if(state == STATE_WORD || state == STATE_PHRASE || state == STATE_PHRASE_GAP) type = finishToken();
+    if(state == STATE_PAGE_START || state == STATE_PAGE) type = TOKEN_PAGE;
+
+    state = STATE_BETWEEN;
+    return type;
+}
+
+/*
+Gets the last word or phrase completed by next or finish
+@return - the null terminated token, as it appeared in the input. It is overwritten by the next token
+*/
+char* Tokenizer::getToken(){
+    return token;
+}
+
+/*
+Gets the last page number completed by next or finish
+@return - the page number
+*/
+int Tokenizer::getPage() const{
+    return page;
+}
@@ -0,0 +1,37 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+//The longest word or phrase kept by the tokenizer. Longer ones are cut off
+#define TOKEN_MAX_LENGTH 40
+
+//Results of Tokenizer::next
+#define TOKEN_NONE 0 //The input ran out before another token was completed
+#define TOKEN_WORD 1 //A word or [multi word phrase] is ready in getToken
+#define TOKEN_PAGE 2 //A <n> page marker is ready in getPage
+#define TOKEN_END 3 //A <-n> end marker was found
+
+/*
+ * The Tokenizer class splits input into words, [multi word phrases] and <n> page markers in a single pass.
+ * It is a state machine fed one buffer at a time: a token cut off at the end of a buffer is carried over
+ * and completed by the next one, so phrases can straddle buffers (or daemon commands).
+ * Tokens are built in a fixed buffer inside the tokenizer, so no memory is allocated per token
+ */
+class Tokenizer
+{
+private:
+    int state; //What the characters being read belong to, one of the states listed in tokenizer.cpp
+    char token[TOKEN_MAX_LENGTH + 1]; //The word or phrase being built, null terminated once it is complete
+    int length; //Number of chars in token
+    int page; //The page number being built, or the last one completed
+    bool pageDigitsDone; //Set once a non digit is found in a page marker, or the number would pass INT_MAX, so that later digits are ignored
+    int finishToken(); //Ends the word or phrase being built, returning TOKEN_WORD or TOKEN_NONE if it is empty
+
+public:
+    Tokenizer(); //Default constructor
+    int next(const char*&, const char*); //Reads from a buffer until a token is completed or the buffer runs out
+    int finish(); //Completes whatever token was left unfinished when the input ended
+    char* getToken(); //Gets the last completed word or phrase
+    int getPage() const; //Gets the last completed page number
+};
+
+#endif